@@ -84,6 +84,7 @@ class TinyGsmA6 : public TinyGsmModem<TinyGsmA6>,
       this->at       = modem;
       this->mux      = -1;
       sock_connected = false;
+      state_check    = 0;
 
       return true;
     }
@@ -163,6 +164,10 @@ class TinyGsmA6 : public TinyGsmModem<TinyGsmA6>,
 
     DBG(GF("### Modem:"), getModemName());
 
+    // Keep the registration and PDP context state up to date from URCs
+    enableRegistrationReports(REG_REPORT_CREG);
+    enablePdpEvents();
+
     SimStatus ret = getSimStatus();
     // if the sim isn't ready and a pin has been provided, try to unlock the sim
     if (ret != SIM_READY && pin != nullptr && strlen(pin) > 0) {
@@ -210,8 +215,10 @@ class TinyGsmA6 : public TinyGsmModem<TinyGsmA6>,
 
   bool sleepEnableImpl(bool enable = true) TINY_GSM_ATTR_NOT_AVAILABLE;
 
-  bool setPhoneFunctionalityImpl(uint8_t fun, bool reset = false)
-      TINY_GSM_ATTR_NOT_IMPLEMENTED;
+  bool setPhoneFunctionalityImpl(uint8_t fun, bool reset = false) {
+    sendAT(GF("+CFUN="), fun, reset ? ",1" : "");
+    return waitResponse(10000L) == 1;
+  }
 
   /*
    * Generic network functions
@@ -492,7 +499,7 @@ class TinyGsmA6 : public TinyGsmModem<TinyGsmA6>,
   int16_t modemSend(const void* buff, size_t len, uint8_t mux) {
     sendAT(GF("+CIPSEND="), mux, ',', (uint16_t)len);
     if (waitResponse(2000L, GF(AT_NL ">")) != 1) { return 0; }
-    stream.write(reinterpret_cast<const uint8_t*>(buff), len);
+    streamWriteSendData(buff, len);
     stream.flush();
     if (waitResponse(10000L, GFP(GSM_OK), GF(AT_NL "FAIL")) != 1) { return 0; }
     return len;
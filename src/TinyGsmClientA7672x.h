@@ -72,6 +72,14 @@ class TinyGsmA7672X : public TinyGsmModem<TinyGsmA7672X>,
   friend class TinyGsmBattery<TinyGsmA7672X>;
   friend class TinyGsmTemperature<TinyGsmA7672X>;
 
+  /*
+   * Socket command limits
+   */
+ public:
+  struct Traits : TinyGsmTcpTraits {
+    static constexpr size_t maxReadSize = 1500;
+  };
+
   /*
    * Inner Client
    */
@@ -193,6 +201,9 @@ class TinyGsmA7672X : public TinyGsmModem<TinyGsmA7672X>,
 
     if (!testAT(2000)) { return false; }
 
+    // A restart loses the SSL settings
+    ssl_config.clear();
+
     // sendAT(GF("&FZ"));  // Factory + Reset
     // waitResponse();
 
@@ -208,6 +219,10 @@ class TinyGsmA7672X : public TinyGsmModem<TinyGsmA7672X>,
 
     DBG(GF("### Modem:"), getModemName());
 
+    // Keep the registration and PDP context state up to date from URCs
+    enableRegistrationReports(REG_REPORT_CREG);
+    enablePdpEvents();
+
     SimStatus ret = getSimStatus();
     // if the sim isn't ready and a pin has been provided, try to unlock the sim
     if (ret != SIM_READY && pin != nullptr && strlen(pin) > 0) {
@@ -243,7 +258,9 @@ class TinyGsmA7672X : public TinyGsmModem<TinyGsmA7672X>,
     waitResponse();
     if (!setPhoneFunctionality(0)) { return false; }
     if (!setPhoneFunctionality(1, true)) { return false; }
-    delay(3000);
+    // *ATREADY comes once commands are taken, or else the start up URCs end
+    // with PB DONE
+    waitResponse(10000L, GF("*ATREADY"), GF("PB DONE"));
     return init(pin);
   }
 
@@ -308,13 +325,13 @@ class TinyGsmA7672X : public TinyGsmModem<TinyGsmA7672X>,
   /*
    * Secure socket layer (SSL) functions
    */
- public:
+ protected:
   // The name of the certificate/key/password file. The file name must
   // havetype like ".pem" or ".der".
   // The certificate like - const char ca_cert[] PROGMEM =  R"EOF(-----BEGIN...
   // len of certificate like - sizeof(ca_cert)
-  bool addCertificate(const char* certificateName, const char* cert,
-                      const uint16_t len) {
+  bool addCertificateImpl(const char* certificateName, const char* cert,
+                          const uint16_t len) {
     sendAT(GF("+CCERTDOWN="), certificateName, GF(","), len);
     if (waitResponse(GF(">")) != 1) { return false; }
     stream.write(cert, len);
@@ -322,7 +339,20 @@ class TinyGsmA7672X : public TinyGsmModem<TinyGsmA7672X>,
     return waitResponse() == 1;
   }
 
-  bool deleteCertificate(const char* certificateName) {  // todo test
+  // The module only lists certificate names, not their sizes, so this always
+  // uploads
+  bool addCertificateImpl(const char* certificateName, TinyGsmSendSource& cert,
+                          size_t len, bool) {
+    sendAT(GF("+CCERTDOWN="), certificateName, GF(","), len);
+    if (waitResponse(GF(">")) != 1) { return false; }
+    send_source = &cert;
+    streamWriteSendData(nullptr, len);
+    send_source = nullptr;
+    stream.flush();
+    return waitResponse() == 1;
+  }
+
+  bool deleteCertificateImpl(const char* certificateName) {  // todo test
     sendAT(GF("+CCERTDELE="), certificateName);
     return waitResponse() == 1;
   }
@@ -395,7 +425,8 @@ class TinyGsmA7672X : public TinyGsmModem<TinyGsmA7672X>,
     for (uint32_t start = millis(); millis() - start < timeout_ms;) {
       sendAT(GF("+CPIN?"));
       if (waitResponse(GF("+CPIN:")) != 1) {
-        delay(1000);
+        // Ask again as soon as the SIM says it's ready
+        waitResponse(1000L, GF("+CPIN: READY"));
         continue;
       }
       int8_t status = waitResponse(GF("READY"), GF("SIM PIN"), GF("SIM PUK"),
@@ -498,29 +529,37 @@ class TinyGsmA7672X : public TinyGsmModem<TinyGsmA7672X>,
       // set the ssl version
       // AT+CSSLCFG="sslversion",<ssl_ctx_index>,<sslversion>
       // <ctxindex> PDP context identifier
-      // <sslversion> 0: QAPI_NET_SSL_PROTOCOL_UNKNOWN
-      //              1: QAPI_NET_SSL_PROTOCOL_TLS_1_0
-      //              2: QAPI_NET_SSL_PROTOCOL_TLS_1_1
-      //              3: QAPI_NET_SSL_PROTOCOL_TLS_1_2
-      //              4: QAPI_NET_SSL_PROTOCOL_DTLS_1_0
-      //              5: QAPI_NET_SSL_PROTOCOL_DTLS_1_2
+      // <sslversion> 0: SSL 3.0
+      //              1: TLS 1.0
+      //              2: TLS 1.1
+      //              3: TLS 1.2
+      //              4: All
       // NOTE:  despite docs using caps, "sslversion" must be in lower case
-      sendAT(GF("+CSSLCFG=\"sslversion\",0,3"));  // TLS 1.2
-      if (waitResponse(5000L) != 1) return false;
+      // The version comes from the socket's TLS profile.  The settings stay
+      // in the module, so only send those that changed.
+      uint8_t version = tls_profiles[mux].versionOrAll();
+      char version_str[2] = {static_cast<char>('0' + version), '\0'};
+      if (ssl_config.needs(0, SSL_CFG_VERSION, version_str)) {
+        sendAT(GF("+CSSLCFG=\"sslversion\",0,"), version);
+        if (!sslConfigOk()) return false;
+      }
 
 
-      if (certificates[mux] != "") {
+      if (certificates[mux] != "" &&
+          ssl_config.needs(0, SSL_CFG_CACERT, certificates[mux].c_str())) {
         /* Configure the server root CA of the specified SSL context
         AT + CSSLCFG = "cacert", <ssl_ ctx_index>,<ca_file> */
         sendAT(GF("+CSSLCFG=\"cacert\",0,"), certificates[mux].c_str());
-        if (waitResponse(5000L) != 1) return false;
+        if (!sslConfigOk()) return false;
       }
 
       // set the SSL SNI (server name indication)
       // AT+CSSLCFG="enableSNI",<ssl_ctx_index>,<enableSNI_flag>
       // NOTE:  despite docs using caps, "sni" must be in lower case
-      sendAT(GF("+CSSLCFG=\"enableSNI\",0,1"));
-      if (waitResponse(2000L) != 1) { return false; }
+      if (ssl_config.needs(0, SSL_CFG_SNI, tls_profiles[mux].sni ? "1" : "0")) {
+        sendAT(GF("+CSSLCFG=\"enableSNI\",0,"), tls_profiles[mux].sni);
+        if (!sslConfigOk()) { return false; }
+      }
 
       // Configure the report mode of sending and receiving data
       /* +CCHSET=<report_send_result>,<recv_mode>
@@ -566,13 +605,21 @@ class TinyGsmA7672X : public TinyGsmModem<TinyGsmA7672X>,
     return (1 == rsp);
   }
 
+  // Waits for the result of an SSL setting, forgetting the applied settings if
+  // it fails
+  bool sslConfigOk() {
+    if (waitResponse(5000L) == 1) { return true; }
+    ssl_config.clear();
+    return false;
+  }
+
   int16_t modemSend(const void* buff, size_t len, uint8_t mux) {
     if (hasSSL)
       sendAT(GF("+CCHSEND="), mux, ',', (uint16_t)len);
     else
       sendAT(GF("+CIPSEND="), mux, ',', (uint16_t)len);
     if (waitResponse(GF(">")) != 1) { return 0; }
-    stream.write(reinterpret_cast<const uint8_t*>(buff), len);
+    streamWriteSendData(buff, len);
     stream.flush();
 
     if (waitResponse() != 1) { return 0; }
@@ -767,9 +814,9 @@ class TinyGsmA7672X : public TinyGsmModem<TinyGsmA7672X>,
   Stream& stream;
 
  protected:
-  GsmClientA7672X* sockets[TINY_GSM_MUX_COUNT];
-  bool             hasSSL = false;
-  String           certificates[TINY_GSM_MUX_COUNT];
+  GsmClientA7672X*         sockets[TINY_GSM_MUX_COUNT];
+  bool                     hasSSL = false;
+  TinyGsmSSLConfigCache<1> ssl_config;  // all sockets use SSL context 0
 };
 
 #endif  // SRC_TINYGSMCLIENTA7672X_H_
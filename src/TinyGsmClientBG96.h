@@ -11,14 +11,28 @@
 // #pragma message("TinyGSM:  TinyGsmClientBG96")
 
 // #define TINY_GSM_DEBUG Serial
+// #define TINY_GSM_BG96_DIRECT_PUSH
+// #define TINY_GSM_USE_DNS_CACHE
 
 #define TINY_GSM_MUX_COUNT 12
+#if !defined(TINY_GSM_SEND_MAX_SIZE)
+#define TINY_GSM_SEND_MAX_SIZE 1460
+#endif
 #define TINY_GSM_BUFFER_READ_AND_CHECK_SIZE
 #ifdef AT_NL
 #undef AT_NL
 #endif
 #define AT_NL "\r\n"
 
+// In direct push mode, the module appends received TCP data directly to the
+// "recv" URC rather than holding it for a QIRD read.  A socket only uses push
+// mode while its FIFO can hold this many bytes - the most the module will push
+// in a single URC.  When the FIFO fills past that point the socket is switched
+// back to buffer mode (and read with QIRD) until the application catches up.
+#if defined(TINY_GSM_BG96_DIRECT_PUSH) && !defined(TINY_GSM_BG96_PUSH_RESERVE)
+#define TINY_GSM_BG96_PUSH_RESERVE 1500
+#endif
+
 #ifdef MODEM_MANUFACTURER
 #undef MODEM_MANUFACTURER
 #endif
@@ -42,6 +56,8 @@
 #include "TinyGsmGPS.tpp"
 #include "TinyGsmTime.tpp"
 #include "TinyGsmNTP.tpp"
+#include "TinyGsmDNS.tpp"
+#include "TinyGsmPowerSave.tpp"
 #include "TinyGsmBattery.tpp"
 #include "TinyGsmTemperature.tpp"
 
@@ -65,7 +81,9 @@ class TinyGsmBG96 : public TinyGsmModem<TinyGsmBG96>,
                     public TinyGsmTime<TinyGsmBG96>,
                     public TinyGsmNTP<TinyGsmBG96>,
                     public TinyGsmBattery<TinyGsmBG96>,
-                    public TinyGsmTemperature<TinyGsmBG96> {
+                    public TinyGsmTemperature<TinyGsmBG96>,
+                    public TinyGsmDNS<TinyGsmBG96>,
+                    public TinyGsmPowerSave<TinyGsmBG96> {
   friend class TinyGsmModem<TinyGsmBG96>;
   friend class TinyGsmGPRS<TinyGsmBG96>;
   friend class TinyGsmTCP<TinyGsmBG96, TINY_GSM_MUX_COUNT>;
@@ -77,6 +95,16 @@ class TinyGsmBG96 : public TinyGsmModem<TinyGsmBG96>,
   friend class TinyGsmNTP<TinyGsmBG96>;
   friend class TinyGsmBattery<TinyGsmBG96>;
   friend class TinyGsmTemperature<TinyGsmBG96>;
+  friend class TinyGsmDNS<TinyGsmBG96>;
+  friend class TinyGsmPowerSave<TinyGsmBG96>;
+
+  /*
+   * Socket command limits
+   */
+ public:
+  struct Traits : TinyGsmTcpTraits {
+    static constexpr size_t maxReadSize = 1500;
+  };
 
   /*
    * Inner Client
@@ -99,6 +127,7 @@ class TinyGsmBG96 : public TinyGsmModem<TinyGsmBG96>,
       prev_check     = 0;
       sock_connected = false;
       got_data       = false;
+      direct_push    = false;
 
       if (mux < TINY_GSM_MUX_COUNT) {
         this->mux = mux;
@@ -138,6 +167,7 @@ class TinyGsmBG96 : public TinyGsmModem<TinyGsmBG96>,
 
    protected:
     bool ssl_sock;
+    bool direct_push;
   };
 
   /*
@@ -181,12 +211,49 @@ class TinyGsmBG96 : public TinyGsmModem<TinyGsmBG96>,
    * Basic functions
    */
  protected:
+#ifdef TINY_GSM_BG96_DIRECT_PUSH
+  void maintainImpl() {
+    // Switch sockets between push and buffer access mode as their FIFOs fill
+    // and drain.  This can't be done from within the URC handler because the
+    // URC may have arrived while waiting for the response to another command.
+    for (int mux = 0; mux < TINY_GSM_MUX_COUNT; mux++) {
+      GsmClientBG96* sock = sockets[mux];
+      if (!sock || sock->ssl_sock || !sock->sock_connected) { continue; }
+      if (sock->direct_push &&
+          sock->rx.free() < TINY_GSM_BG96_PUSH_RESERVE) {
+        // Not enough room for another push - leave the data in the module
+        sendAT(GF("+QISWTMD="), mux, GF(",0"));
+        if (waitResponse() == 1) {
+          DBG("### PUSH PAUSED:", mux);
+          sock->direct_push = false;
+          sock->got_data    = true;
+        }
+      } else if (!sock->direct_push && !sock->got_data &&
+                 sock->sock_available == 0 &&
+                 sock->rx.free() >= TINY_GSM_BG96_PUSH_RESERVE &&
+                 modemGetAvailable(mux) == 0) {
+        // The module buffer is drained and there's room again, resume pushing
+        sendAT(GF("+QISWTMD="), mux, GF(",1"));
+        if (waitResponse() == 1) {
+          DBG("### PUSH RESUMED:", mux);
+          sock->direct_push = true;
+        }
+      }
+    }
+    TinyGsmTCP<TinyGsmBG96, TINY_GSM_MUX_COUNT>::maintainImpl();
+  }
+
+#endif
+
   bool initImpl(const char* pin = nullptr) {
     DBG(GF("### TinyGSM Version:"), TINYGSM_VERSION);
     DBG(GF("### TinyGSM Compiled Module:  TinyGsmClientBG96"));
 
     if (!testAT()) { return false; }
 
+    // A restart loses the SSL settings
+    ssl_config.clear();
+
     sendAT(GF("E0"));  // Echo Off
     if (waitResponse() != 1) { return false; }
 
@@ -207,6 +274,10 @@ class TinyGsmBG96 : public TinyGsmModem<TinyGsmBG96>,
     sendAT(GF("+CTZU=1"));
     if (waitResponse(10000L) != 1) { return false; }
 
+    // Keep the registration and PDP context state up to date from URCs
+    enableRegistrationReports(REG_REPORT_CEREG | REG_REPORT_CREG);
+    enablePdpEvents();
+
     SimStatus ret = getSimStatus();
     // if the sim isn't ready and a pin has been provided, try to unlock the sim
     if (ret != SIM_READY && pin != nullptr && strlen(pin) > 0) {
@@ -252,6 +323,21 @@ class TinyGsmBG96 : public TinyGsmModem<TinyGsmBG96>,
     return waitResponse(timeout_ms, GF("OK")) == 1;
   }
 
+  /*
+   * Extended discontinuous reception (eDRX) functions
+   */
+ protected:
+  // AT+QPTWEDRXS sets the paging time window along with the cycle
+  bool setEDRXImpl(bool enable, EDRXAct act, EDRXCycle cycle, int8_t ptw) {
+    if (!enable || ptw < 0) {
+      return TinyGsmPowerSave<TinyGsmBG96>::setEDRXImpl(enable, act, cycle,
+                                                        ptw);
+    }
+    sendAT(GF("+QPTWEDRXS=1,"), act, ',', quoted(bitString(ptw, 4)), ',',
+           quoted(bitString(cycle, 4)));
+    return waitResponse() == 1;
+  }
+
   /*
    * Generic network functions
    */
@@ -278,7 +364,52 @@ class TinyGsmBG96 : public TinyGsmModem<TinyGsmBG96>,
   /*
    * Secure socket layer (SSL) functions
    */
-  // Follows functions as inherited from TinyGsmSSL.tpp
+ protected:
+  bool addCertificateImpl(const char* certificateName, const char* cert,
+                          const uint16_t len) {
+    TinyGsmIoVec       iov = {cert, len};
+    TinyGsmIoVecSource source(&iov, 1);
+    return addCertificateImpl(certificateName, source, len, false);
+  }
+
+  bool addCertificateImpl(const char* certificateName, TinyGsmSendSource& cert,
+                          size_t len, bool replace) {
+    if (!replace && fileSize(certificateName) == static_cast<int32_t>(len)) {
+      DBG("### Certificate already on the module:", certificateName);
+      return true;
+    }
+    // The upload fails if the file exists
+    deleteCertificateImpl(certificateName);
+
+    // AT+QFUPL=<filename>,<file_size>,<timeout>
+    sendAT(GF("+QFUPL=\""), certificateName, GF("\","), len, GF(",60"));
+    if (waitResponse(10000L, GF("CONNECT")) != 1) { return false; }
+    send_source = &cert;
+    streamWriteSendData(nullptr, len);
+    send_source = nullptr;
+    // +QFUPL: <upload_size>,<checksum>
+    if (waitResponse(60000L, GF("+QFUPL:")) != 1) { return false; }
+    size_t uploaded = streamGetIntBefore(',');
+    streamSkipUntil('\n');
+    waitResponse();
+    return uploaded == len;
+  }
+
+  bool deleteCertificateImpl(const char* certificateName) {
+    sendAT(GF("+QFDEL=\""), certificateName, '"');
+    return waitResponse() == 1;
+  }
+
+  // The size of a file in the module's file system, or -1 if there's no such
+  // file
+  int32_t fileSize(const char* filename) {
+    sendAT(GF("+QFLST=\""), filename, '"');
+    if (waitResponse(GF("+QFLST:")) != 1) { return -1; }
+    streamSkipUntil(',');  // Skip the name
+    int32_t size = streamGetIntBefore('\n');
+    waitResponse();
+    return size;
+  }
 
   /*
    * WiFi functions
@@ -325,6 +456,60 @@ class TinyGsmBG96 : public TinyGsmModem<TinyGsmBG96>,
     return res;
   }
 
+  /*
+   * Fast attach functions
+   */
+ protected:
+  // Reads the band from AT+QNWINFO: <act>,<oper>,<band>,<channel>, ie:
+  // "CAT-M1","26201","LTE BAND 20",6300
+  uint16_t getServingBandImpl() {
+    sendAT(GF("+QNWINFO"));
+    if (waitResponse(GF("+QNWINFO:")) != 1) { return 0; }
+    String line = stream.readStringUntil('\n');
+    waitResponse();
+    int band = line.indexOf("BAND ");
+    return band < 0 ? 0 : line.substring(band + 5).toInt();
+  }
+
+  // Scans the access technology that served last first: 02 eMTC, 03 NB-IoT,
+  // 01 GSM
+  bool setAttachProfileImpl(const TinyGsmAttachProfile& profile,
+                            uint32_t                    timeout_ms) {
+    const char* seq = profile.act == 9 ? "030201"
+        : profile.act == 0             ? "010203"
+                                       : "020301";
+    sendAT(GF("+QCFG=\"nwscanseq\","), seq, GF(",1"));
+    waitResponse();
+    return TinyGsmGPRS<TinyGsmBG96>::setAttachProfileImpl(profile,
+                                                          timeout_ms);
+  }
+
+  /*
+   * DNS functions
+   */
+ protected:
+  bool dnsLookupImpl(const char* host, String& ip, uint32_t& ttl_ms) {
+    // AT+QIDNSGIP=<contextID>,"<hostname>"
+    // The result comes in +QIURC: "dnsgip" URCs, which handleURCs picks up
+    dns_ip    = "";
+    dns_err   = -1;
+    dns_ttl_s = 0;
+    sendAT(GF("+QIDNSGIP=1,\""), host, '"');
+    if (waitResponse() != 1) { return false; }
+    uint32_t startMillis = millis();
+    while (!dns_ip.length() && dns_err <= 0 &&
+           millis() - startMillis < 60000L) {
+      waitResponse(100, nullptr, nullptr);
+    }
+    if (!dns_ip.length()) { return false; }
+    ip = dns_ip;
+    // Keep the address no longer than the TTL the module reports
+    if (dns_ttl_s > 0 && dns_ttl_s * 1000 < ttl_ms) {
+      ttl_ms = dns_ttl_s * 1000;
+    }
+    return true;
+  }
+
   /*
    * SIM card functions
    */
@@ -623,59 +808,81 @@ class TinyGsmBG96 : public TinyGsmModem<TinyGsmBG96>,
     bool     ssl        = sockets[mux]->ssl_sock;
 
     if (ssl) {
+      // Every socket uses SSL context 0, set up from its TLS profile as it
+      // connects.  The settings stay in the module, so only send those that
+      // changed.
+      const TinyGsmTLSProfile& profile = tls_profiles[mux];
+
       // set the ssl version
       // AT+QSSLCFG="sslversion",<ctxindex>,<sslversion>
-      // <ctxindex> PDP context identifier
+      // <ctxindex> SSL context identifier
       // <sslversion> 0: QAPI_NET_SSL_3.0
       //              1: QAPI_NET_SSL_PROTOCOL_TLS_1_0
       //              2: QAPI_NET_SSL_PROTOCOL_TLS_1_1
       //              3: QAPI_NET_SSL_PROTOCOL_TLS_1_2
       //              4: ALL
       // NOTE:  despite docs using caps, "sslversion" must be in lower case
-      sendAT(GF("+QSSLCFG=\"sslversion\",0,3"));  // TLS 1.2
-      if (waitResponse(5000L) != 1) return false;
+      uint8_t version = profile.versionOrAll();
+      char version_str[2] = {static_cast<char>('0' + version), '\0'};
+      if (ssl_config.needs(0, SSL_CFG_VERSION, version_str)) {
+        sendAT(GF("+QSSLCFG=\"sslversion\",0,"), version);
+        if (!sslConfigOk()) return false;
+      }
       // set the ssl cipher_suite
       // AT+QSSLCFG="ciphersuite",<ctxindex>,<cipher_suite>
-      // <ctxindex> PDP context identifier
-      // <cipher_suite> 0: TODO
-      //              1: TODO
+      // <ctxindex> SSL context identifier
+      // <cipher_suite> the suite's number in hex, ie:
       //              0X0035: TLS_RSA_WITH_AES_256_CBC_SHA
+      //              0XC02F: TLS_ECDHE_RSA_WITH_AES_128_GCM_SHA256
       //              0XFFFF: ALL
-      // NOTE:  despite docs using caps, "sslversion" must be in lower case
-      sendAT(GF(
-          "+QSSLCFG=\"ciphersuite\",0,0X0035"));  // TLS_RSA_WITH_AES_256_CBC_SHA
-      if (waitResponse(5000L) != 1) return false;
+      char suite[7] = "0XFFFF";
+      if (profile.cipher_suite) {
+        static const char digits[] = "0123456789ABCDEF";
+        for (uint8_t i = 0; i < 4; i++) {
+          suite[2 + i] = digits[(profile.cipher_suite >> (12 - 4 * i)) & 0xF];
+        }
+      }
+      if (ssl_config.needs(0, SSL_CFG_CIPHERS, suite)) {
+        sendAT(GF("+QSSLCFG=\"ciphersuite\",0,"), suite);
+        if (!sslConfigOk()) return false;
+      }
       // set the ssl sec level
       // AT+QSSLCFG="seclevel",<ctxindex>,<sec_level>
-      // <ctxindex> PDP context identifier
-      // <sec_level> 0: TODO
-      //              1: TODO
-      //              0X0035: TLS_RSA_WITH_AES_256_CBC_SHA
-      //              0XFFFF: ALL
-      // NOTE:  despite docs using caps, "sslversion" must be in lower case
-      sendAT(GF("+QSSLCFG=\"seclevel\",0,1"));
-      if (waitResponse(5000L) != 1) return false;
-
+      // <ctxindex> SSL context identifier
+      // <sec_level> 0: No authentication
+      //             1: Manage server authentication (needs a CA certificate)
+      //             2: Manage server and client authentication
+      const char* seclevel = certificates[mux] != "" ? "1" : "0";
+      if (ssl_config.needs(0, SSL_CFG_SECLEVEL, seclevel)) {
+        sendAT(GF("+QSSLCFG=\"seclevel\",0,"), seclevel);
+        if (!sslConfigOk()) return false;
+      }
 
-      if (certificates[mux] != "") {
+      if (certificates[mux] != "" &&
+          ssl_config.needs(0, SSL_CFG_CACERT, certificates[mux].c_str())) {
         // apply the correct certificate to the connection
         // AT+QSSLCFG="cacert",<ctxindex>,<caname>
-        // <ctxindex> PDP context identifier
+        // <ctxindex> SSL context identifier
         // <certname> certificate name
-
-        // sendAT(GF("+CASSLCFG="), mux, ",CACERT,\"",
-        // certificates[mux].c_str(),
-        //        "\"");
         sendAT(GF("+QSSLCFG=\"cacert\",0,\""), certificates[mux].c_str(),
                GF("\""));
-        if (waitResponse(5000L) != 1) return false;
+        if (!sslConfigOk()) return false;
+      }
+
+      // turn server name indication on or off
+      // AT+QSSLCFG="sni",<ctxindex>,<SNI>
+      // NOTE:  older firmware doesn't have this, so an error is ignored
+      if (ssl_config.needs(0, SSL_CFG_SNI, profile.sni ? "1" : "0")) {
+        sendAT(GF("+QSSLCFG=\"sni\",0,"), profile.sni);
+        waitResponse(5000L);
       }
 
       // <PDPcontextID>(1-16), <connectID>(0-11),
       // "TCP/UDP/TCP LISTENER/UDPSERVICE", "<IP_address>/<domain_name>",
       // <remote_port>,<local_port>,<access_mode>(0-2; 0=buffer)
       // may need previous AT+QSSLCFG
-      sendAT(GF("+QSSLOPEN=1,1,"), mux, GF(",\""), host, GF("\","), port,
+      // <PDPcontextID>,<SSLcontextID>,<clientID>,<serveraddr>,<server_port>
+      sendAT(GF("+QSSLOPEN=1,0,"), mux, GF(",\""), host, GF("\","), port,
              GF(",0"));
       waitResponse();
 
@@ -688,38 +895,83 @@ class TinyGsmBG96 : public TinyGsmModem<TinyGsmBG96>,
       if (streamGetIntBefore(',') != mux) { return false; }
       // Read status
       return (0 == streamGetIntBefore('\n'));
-    } else {
-      // AT+QIOPEN=1,0,"TCP","220.180.239.212",8009,0,0
-      // <PDPcontextID>(1-16), <connectID>(0-11),
-      // "TCP/UDP/TCP LISTENER/UDPSERVICE", "<IP_address>/<domain_name>",
-      // <remote_port>,<local_port>,<access_mode>(0-2; 0=buffer)
-      sendAT(GF("+QIOPEN=1,"), mux, GF(",\""), GF("TCP"), GF("\",\""), host,
-             GF("\","), port, GF(",0,0"));
-      waitResponse();
+    }
 
-      if (waitResponse(timeout_ms, GF(AT_NL "+QIOPEN:")) != 1) { return false; }
+    if (!modemBeginConnect(host, port, mux, timeout_s) ||
+        waitResponse(timeout_ms, GF(AT_NL "+QIOPEN:")) != 1 ||
+        streamGetIntBefore(',') != mux || streamGetIntBefore('\n') != 0) {
+      forgetHostIP(host);
+      return false;
+    }
+    return true;
+  }
 
-      if (streamGetIntBefore(',') != mux) { return false; }
+  // Waits for the result of an SSL setting, forgetting the applied settings if
+  // it fails
+  bool sslConfigOk() {
+    if (waitResponse(5000L) == 1) { return true; }
+    ssl_config.clear();
+    return false;
+  }
+
+  // Sends the open command, leaving the +QIOPEN: <connectID>,<err> result to
+  // the caller or to handleURCs
+  bool modemBeginConnect(const char* host, uint16_t port, uint8_t mux, int) {
+    if (sockets[mux]->ssl_sock) {
+      DBG("### SSL sockets must be connected one at a time");
+      return false;
     }
-    // Read status
-    return (0 == streamGetIntBefore('\n'));
+    // AT+QIOPEN=1,0,"TCP","220.180.239.212",8009,0,0
+    // <PDPcontextID>(1-16), <connectID>(0-11),
+    // "TCP/UDP/TCP LISTENER/UDPSERVICE", "<IP_address>/<domain_name>",
+    // <remote_port>,<local_port>,<access_mode>(0-2; 0=buffer, 1=direct push)
+    bool push = false;
+#ifdef TINY_GSM_BG96_DIRECT_PUSH
+    // Only push if the FIFO is big enough to take a full push
+    push = sockets[mux]->rx.free() >= TINY_GSM_BG96_PUSH_RESERVE;
+#endif
+    sockets[mux]->direct_push = push;
+    String addr               = hostToConnect(host);
+    sendAT(GF("+QIOPEN=1,"), mux, GF(",\""), GF("TCP"), GF("\",\""), addr,
+           GF("\","), port, GF(",0,"), push ? 1 : 0);
+    return waitResponse() == 1;
   }
 
-  int16_t modemSend(const void* buff, size_t len, uint8_t mux) {
+  // The module takes several QIOPEN commands before the first one completes
+  template <class clientType>
+  uint8_t connectManyImpl(clientType* clients[], const char* const hosts[],
+                          const uint16_t ports[], uint8_t count,
+                          int timeout_s) {
+    return connectManyConcurrent(clients, hosts, ports, count, timeout_s);
+  }
+
+  // rai is the release assistance indication the BG95 takes with a plain
+  // TCP send: 1 when no more data is expected
+  int16_t modemSend(const void* buff, size_t len, uint8_t mux,
+                    uint8_t rai = 0) {
     bool ssl = sockets[mux]->ssl_sock;
     if (ssl) {
       sendAT(GF("+QSSLSEND="), mux, ',', (uint16_t)len);
+    } else if (rai) {
+      sendAT(GF("+QISEND="), mux, ',', (uint16_t)len, ',', rai);
     } else {
       sendAT(GF("+QISEND="), mux, ',', (uint16_t)len);
     }
     if (waitResponse(GF(">")) != 1) { return 0; }
-    stream.write(reinterpret_cast<const uint8_t*>(buff), len);
+    streamWriteSendData(buff, len);
     stream.flush();
     if (waitResponse(GF(AT_NL "SEND OK")) != 1) { return 0; }
     // TODO(?): Wait for ACK? (AT+QISEND=id,0 or AT+QSSLSEND=id,0)
     return len;
   }
 
+  int16_t modemSendLast(const void* buff, size_t len, uint8_t mux) {
+#if defined(TINY_GSM_MODEM_BG95) || defined(TINY_GSM_MODEM_BG95SSL)
+    if (!sockets[mux]->ssl_sock) { return modemSend(buff, len, mux, 1); }
+#endif
+    return modemSendThenCNMPSD(buff, len, mux);
+  }
+
   size_t modemRead(size_t size, uint8_t mux) {
     if (!sockets[mux]) return 0;
     bool ssl = sockets[mux]->ssl_sock;
@@ -755,6 +1007,9 @@ class TinyGsmBG96 : public TinyGsmModem<TinyGsmBG96>,
         if (result) { DBG("### DATA AVAILABLE:", result, "on", mux); }
         waitResponse();
       }
+    } else if (sockets[mux]->direct_push) {
+      // Nothing is held in the module in push mode, and QIRD would error
+      result = 0;
     } else {
       sendAT(GF("+QIRD="), mux, GF(",0"));
       if (waitResponse(GF("+QIRD:")) == 1) {
@@ -818,10 +1073,55 @@ class TinyGsmBG96 : public TinyGsmModem<TinyGsmBG96>,
       String urc = stream.readStringUntil('\"');
       streamSkipUntil(',');
       if (urc == "recv") {
-        int8_t mux = streamGetIntBefore('\n');
-        DBG("### URC RECV:", mux);
-        if (mux >= 0 && mux < TINY_GSM_MUX_COUNT && sockets[mux]) {
-          sockets[mux]->got_data = true;
+        // Buffer mode:       +QIURC: "recv",<connectID>
+        // Direct push mode:  +QIURC: "recv",<connectID>,<len><CR><LF><data>
+        String  params = stream.readStringUntil('\n');
+        int8_t  mux    = params.toInt();
+        int     comma  = params.indexOf(',');
+        int16_t len    = comma < 0 ? 0 : params.substring(comma + 1).toInt();
+        DBG("### URC RECV:", mux, len);
+        bool known = mux >= 0 && mux < TINY_GSM_MUX_COUNT && sockets[mux];
+        if (comma < 0) {
+          if (known) { sockets[mux]->got_data = true; }
+        } else {
+          // The pushed data has to be taken off the stream whether or not
+          // there's a socket for it
+          int16_t room = 0;
+          if (known) {
+            size_t free = sockets[mux]->rx.free();
+            room = free < static_cast<size_t>(len) ? free : len;
+          }
+          if (known && room < len) {
+            // Bytes are lost, so the socket's data can't be trusted any more
+            DBG("### Buffer overflow: ", len, "received vs", room,
+                "available; closing", mux);
+            sockets[mux]->sock_connected = false;
+          }
+          for (int16_t i = 0; i < len; i++) {
+            if (i < room) {
+              moveCharFromStreamToFifo(mux);
+              continue;
+            }
+            uint32_t startMillis = millis();
+            while (!stream.available() && millis() - startMillis < 1000L) {
+              TINY_GSM_YIELD();
+            }
+            stream.read();
+          }
+        }
+      } else if (urc == "dnsgip") {
+        // +QIURC: "dnsgip",<err>,<IP_count>,<DNS_ttl>
+        // then +QIURC: "dnsgip","<IP_addr>" for each address
+        String params = stream.readStringUntil('\n');
+        params.trim();
+        if (params.startsWith("\"")) {
+          if (!dns_ip.length()) {
+            dns_ip = params.substring(1, params.length() - 1);
+          }
+        } else {
+          dns_err   = params.toInt();
+          int comma = params.lastIndexOf(',');
+          dns_ttl_s = comma < 0 ? 0 : params.substring(comma + 1).toInt();
         }
       } else if (urc == "closed") {
         int8_t mux = streamGetIntBefore('\n');
@@ -829,11 +1129,29 @@ class TinyGsmBG96 : public TinyGsmModem<TinyGsmBG96>,
         if (mux >= 0 && mux < TINY_GSM_MUX_COUNT && sockets[mux]) {
           sockets[mux]->sock_connected = false;
         }
+      } else if (urc == "pdpdeact") {
+        // +QIURC: "pdpdeact",<contextID>
+        int8_t context = streamGetIntBefore('\n');
+        DBG("### URC PDP DEACT:", context);
+        if (context == 1) { pdpChanged(0); }
       } else {
         streamSkipUntil('\n');
       }
       data = "";
       return true;
+    } else if (data.endsWith(GF(AT_NL "+QIOPEN:"))) {
+      // The result of an open from connectMany()
+      int8_t  mux = streamGetIntBefore(',');
+      int16_t err = streamGetIntBefore('\n');
+      // A late result for an open that already timed out is ignored
+      if (mux >= 0 && mux < TINY_GSM_MUX_COUNT && sockets[mux] &&
+          sockets[mux]->sock_opening) {
+        sockets[mux]->sock_connected = (err == 0);
+        sockets[mux]->sock_opening   = false;
+      }
+      data = "";
+      DBG("### Opened:", mux, err);
+      return true;
     }
     return false;
   }
@@ -842,8 +1160,11 @@ class TinyGsmBG96 : public TinyGsmModem<TinyGsmBG96>,
   Stream& stream;
 
  protected:
-  GsmClientBG96* sockets[TINY_GSM_MUX_COUNT];
-  String         certificates[TINY_GSM_MUX_COUNT];
+  GsmClientBG96*           sockets[TINY_GSM_MUX_COUNT];
+  TinyGsmSSLConfigCache<1> ssl_config;  // all sockets use SSL context 0
+  String                   dns_ip;
+  int16_t                  dns_err;
+  uint32_t                 dns_ttl_s;
 };
 
 #endif  // SRC_TINYGSMCLIENTBG96_H_
@@ -11,9 +11,19 @@
 // #pragma message("TinyGSM:  TinyGsmClientESP8266")
 
 // #define TINY_GSM_DEBUG Serial
+// #define TINY_GSM_ESP8266_PASSIVE_RECV
 
 #define TINY_GSM_MUX_COUNT 5
+#if !defined(TINY_GSM_SEND_MAX_SIZE)
+#define TINY_GSM_SEND_MAX_SIZE 2048
+#endif
+#ifdef TINY_GSM_ESP8266_PASSIVE_RECV
+// In passive receive mode (AT+CIPRECVMODE=1) the module holds incoming data
+// until it's read with AT+CIPRECVDATA instead of pushing it out with +IPD
+#define TINY_GSM_BUFFER_READ_AND_CHECK_SIZE
+#else
 #define TINY_GSM_NO_MODEM_BUFFER
+#endif
 #ifdef AT_NL
 #undef AT_NL
 #endif
@@ -82,7 +92,11 @@ class TinyGsmESP8266 : public TinyGsmModem<TinyGsmESP8266>,
 
     bool init(TinyGsmESP8266* modem, uint8_t mux = 0) {
       this->at       = modem;
+      sock_available = 0;
+      prev_check     = 0;
       sock_connected = false;
+      state_check    = 0;
+      got_data       = false;
 
       if (mux < TINY_GSM_MUX_COUNT) {
         this->mux = mux;
@@ -168,6 +182,10 @@ class TinyGsmESP8266 : public TinyGsmModem<TinyGsmESP8266>,
     if (waitResponse() != 1) { return false; }
     sendAT(GF("+CIPMUX=1"));  // Enable Multiple Connections
     if (waitResponse() != 1) { return false; }
+#ifdef TINY_GSM_ESP8266_PASSIVE_RECV
+    sendAT(GF("+CIPRECVMODE=1"));  // Hold received data until it's requested
+    if (waitResponse() != 1) { return false; }
+#endif
     sendAT(GF("+CWMODE=1"));  // Put into "station" mode
     if (waitResponse() != 1) {
       sendAT(GF("+CWMODE_CUR=1"));  // Attempt "current" station mode command
@@ -451,12 +469,53 @@ class TinyGsmESP8266 : public TinyGsmModem<TinyGsmESP8266>,
   int16_t modemSend(const void* buff, size_t len, uint8_t mux) {
     sendAT(GF("+CIPSEND="), mux, ',', (uint16_t)len);
     if (waitResponse(GF(">")) != 1) { return 0; }
-    stream.write(reinterpret_cast<const uint8_t*>(buff), len);
+    streamWriteSendData(buff, len);
     stream.flush();
     if (waitResponse(10000L, GF(AT_NL "SEND OK" AT_NL)) != 1) { return 0; }
     return len;
   }
 
+#ifdef TINY_GSM_ESP8266_PASSIVE_RECV
+  size_t modemRead(size_t size, uint8_t mux) {
+    if (!sockets[mux]) { return 0; }
+    sendAT(GF("+CIPRECVDATA="), mux, ',', (uint16_t)size);
+    if (waitResponse(GF("+CIPRECVDATA")) != 1) { return 0; }
+    // Older firmware:  +CIPRECVDATA,<actual_len>:<data>
+    // ESP-AT:          +CIPRECVDATA:<actual_len>,<data>
+    int16_t len = stream.parseInt();
+    stream.read();  // skip the ':' or ',' before the data
+    for (int i = 0; i < len; i++) { moveCharFromStreamToFifo(mux); }
+    waitResponse();
+    // DBG("### READ:", len, "from", mux);
+    sockets[mux]->sock_available = modemGetAvailable(mux);
+    return len;
+  }
+
+  size_t modemGetAvailable(uint8_t mux) {
+    if (!sockets[mux]) { return 0; }
+    // The length query covers all links at once
+    // +CIPRECVLEN:<len link 0>,<len link 1>,<len link 2>,<len link 3>,<len 4>
+    sendAT(GF("+CIPRECVLEN?"));
+    if (waitResponse(GF("+CIPRECVLEN:")) != 1) { return 0; }
+    size_t result = 0;
+    for (int muxNo = 0; muxNo < TINY_GSM_MUX_COUNT; muxNo++) {
+      // Unconnected links may be reported as -1
+      int16_t len = streamGetIntBefore(
+          muxNo == TINY_GSM_MUX_COUNT - 1 ? '\n' : ',');
+      if (len < 0) { len = 0; }
+      if (muxNo == mux) {
+        result = len;
+      } else if (sockets[muxNo]) {
+        sockets[muxNo]->sock_available = len;
+      }
+    }
+    waitResponse();
+    if (result) { DBG("### DATA AVAILABLE:", result, "on", mux); }
+    if (!result) { sockets[mux]->sock_connected = modemGetConnected(mux); }
+    return result;
+  }
+#endif
+
   bool modemGetConnected(uint8_t mux) {
     sendAT(GF("+CIPSTATUS"));
     if (waitResponse(3000, GF("STATUS:")) != 1) { return false; }
@@ -500,6 +559,19 @@ class TinyGsmESP8266 : public TinyGsmModem<TinyGsmESP8266>,
    */
  public:
   bool handleURCs(String& data) {
+#ifdef TINY_GSM_ESP8266_PASSIVE_RECV
+    if (data.endsWith(GF("+IPD,"))) {
+      // In passive mode the URC only announces the data:  +IPD,<mux>,<len>
+      int8_t  mux = streamGetIntBefore(',');
+      int16_t len = streamGetIntBefore('\n');
+      if (mux >= 0 && mux < TINY_GSM_MUX_COUNT && sockets[mux]) {
+        sockets[mux]->got_data = true;
+      }
+      data = "";
+      DBG("### Got Data: ", len, "on", mux);
+      return true;
+    }
+#else
     if (data.endsWith(GF("+IPD,"))) {
       int8_t  mux      = streamGetIntBefore(',');
       int16_t len      = streamGetIntBefore(':');
@@ -520,7 +592,9 @@ class TinyGsmESP8266 : public TinyGsmModem<TinyGsmESP8266>,
       data = "";
       DBG("### Got Data: ", len_orig, "on", mux);
       return true;
-    } else if (data.endsWith(GF("CLOSED"))) {
+    }
+#endif
+    else if (data.endsWith(GF("CLOSED"))) {
       int8_t muxStart = TinyGsmMax(0,
                                    data.lastIndexOf(AT_NL, data.length() - 8));
       int8_t coma     = data.indexOf(',', muxStart);
@@ -73,6 +73,7 @@ class TinyGsmM590 : public TinyGsmModem<TinyGsmM590>,
     bool init(TinyGsmM590* modem, uint8_t mux = 0) {
       this->at       = modem;
       sock_connected = false;
+      state_check    = 0;
 
       if (mux < TINY_GSM_MUX_COUNT) {
         this->mux = mux;
@@ -147,6 +148,10 @@ class TinyGsmM590 : public TinyGsmModem<TinyGsmM590>,
 
     DBG(GF("### Modem:"), getModemName());
 
+    // Keep the registration and PDP context state up to date from URCs
+    enableRegistrationReports(REG_REPORT_CREG);
+    enablePdpEvents();
+
     SimStatus ret = getSimStatus();
     // if the sim isn't ready and a pin has been provided, try to unlock the sim
     if (ret != SIM_READY && pin != nullptr && strlen(pin) > 0) {
@@ -304,7 +309,7 @@ class TinyGsmM590 : public TinyGsmModem<TinyGsmM590>,
 
     const uint32_t timeout_ms = 60000L;
     for (uint32_t start = millis(); millis() - start < timeout_ms;) {
-      if (isGprsConnected()) {
+      if (isGprsConnectedImpl()) {
         // goto set_dns; // TODO
         return true;
       }
@@ -431,7 +436,7 @@ class TinyGsmM590 : public TinyGsmModem<TinyGsmM590>,
   int16_t modemSend(const void* buff, size_t len, uint8_t mux) {
     sendAT(GF("+TCPSEND="), mux, ',', (uint16_t)len);
     if (waitResponse(GF(">")) != 1) { return 0; }
-    stream.write(reinterpret_cast<const uint8_t*>(buff), len);
+    streamWriteSendData(buff, len);
     stream.write(static_cast<char>(0x0D));
     stream.flush();
     if (waitResponse(30000L, GF(AT_NL "+TCPSEND:")) != 1) { return 0; }
@@ -84,6 +84,7 @@ class TinyGsmM95 : public TinyGsmModem<TinyGsmM95>,
       this->at       = modem;
       sock_available = 0;
       sock_connected = false;
+      state_check    = 0;
 
       if (mux < TINY_GSM_MUX_COUNT) {
         this->mux = mux;
@@ -166,6 +167,10 @@ class TinyGsmM95 : public TinyGsmModem<TinyGsmM95>,
     sendAT(GF("+QNITZ=1"));
     if (waitResponse(10000L) != 1) { return false; }
 
+    // Keep the registration and PDP context state up to date from URCs
+    enableRegistrationReports(REG_REPORT_CREG);
+    enablePdpEvents();
+
     SimStatus ret = getSimStatus();
     // if the sim isn't ready and a pin has been provided, try to unlock the sim
     if (ret != SIM_READY && pin != nullptr && strlen(pin) > 0) {
@@ -211,8 +216,10 @@ class TinyGsmM95 : public TinyGsmModem<TinyGsmM95>,
     return waitResponse() == 1;
   }
 
-  bool setPhoneFunctionalityImpl(uint8_t fun, bool reset = false)
-      TINY_GSM_ATTR_NOT_IMPLEMENTED;
+  bool setPhoneFunctionalityImpl(uint8_t fun, bool reset = false) {
+    sendAT(GF("+CFUN="), fun, reset ? ",1" : "");
+    return waitResponse(10000L) == 1;
+  }
 
   /*
    * Generic network functions
@@ -459,7 +466,7 @@ class TinyGsmM95 : public TinyGsmModem<TinyGsmM95>,
   int16_t modemSend(const void* buff, size_t len, uint8_t mux) {
     sendAT(GF("+QISEND="), mux, ',', (uint16_t)len);
     if (waitResponse(GF(">")) != 1) { return 0; }
-    stream.write(reinterpret_cast<const uint8_t*>(buff), len);
+    streamWriteSendData(buff, len);
     stream.flush();
     if (waitResponse(GF(AT_NL "SEND OK")) != 1) { return 0; }
 
@@ -87,6 +87,7 @@ class TinyGsmMC60 : public TinyGsmModem<TinyGsmMC60>,
       this->at       = modem;
       sock_available = 0;
       sock_connected = false;
+      state_check    = 0;
 
       if (mux < TINY_GSM_MUX_COUNT) {
         this->mux = mux;
@@ -169,6 +170,10 @@ class TinyGsmMC60 : public TinyGsmModem<TinyGsmMC60>,
     sendAT(GF("+QNITZ=1"));
     if (waitResponse(10000L) != 1) { return false; }
 
+    // Keep the registration and PDP context state up to date from URCs
+    enableRegistrationReports(REG_REPORT_CREG);
+    enablePdpEvents();
+
     SimStatus ret = getSimStatus();
     // if the sim isn't ready and a pin has been provided, try to unlock the sim
     if (ret != SIM_READY && pin != nullptr && strlen(pin) > 0) {
@@ -189,7 +194,9 @@ class TinyGsmMC60 : public TinyGsmModem<TinyGsmMC60>,
     if (!testAT()) { return false; }
     if (!setPhoneFunctionality(0)) { return false; }
     if (!setPhoneFunctionality(1, true)) { return false; }
-    delay(3000);
+    // RDY is only sent at a fixed baud rate; an auto-bauding module is found
+    // by the AT test in init() once this times out
+    waitResponse(3000L, GF("RDY"));
     return init(pin);
   }
 
@@ -324,7 +331,8 @@ class TinyGsmMC60 : public TinyGsmModem<TinyGsmMC60>,
     for (uint32_t start = millis(); millis() - start < timeout_ms;) {
       sendAT(GF("+CPIN?"));
       if (waitResponse(GF(AT_NL "+CPIN:")) != 1) {
-        delay(1000);
+        // Ask again as soon as the SIM says it's ready
+        waitResponse(1000L, GF("+CPIN: READY"));
         continue;
       }
       int8_t status = waitResponse(GF("READY"), GF("SIM PIN"), GF("SIM PUK"),
@@ -441,7 +449,7 @@ class TinyGsmMC60 : public TinyGsmModem<TinyGsmMC60>,
   int16_t modemSend(const void* buff, size_t len, uint8_t mux) {
     sendAT(GF("+QISEND="), mux, ',', (uint16_t)len);
     if (waitResponse(GF(">")) != 1) { return 0; }
-    stream.write(reinterpret_cast<const uint8_t*>(buff), len);
+    streamWriteSendData(buff, len);
     stream.flush();
     if (waitResponse(GF(AT_NL "SEND OK")) != 1) { return 0; }
 
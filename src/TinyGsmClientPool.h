@@ -0,0 +1,200 @@
+/**
+ * @file       TinyGsmClientPool.h
+ * @author     Volodymyr Shymanskyy
+ * @license    LGPL-3.0
+ * @copyright  Copyright (c) 2016 Volodymyr Shymanskyy
+ * @date       Oct 2026
+ */
+
+#ifndef SRC_TINYGSMCLIENTPOOL_H_
+#define SRC_TINYGSMCLIENTPOOL_H_
+
+#include "TinyGsmCommon.h"
+
+#ifndef TINY_GSM_POOL_IDLE_TIMEOUT
+#define TINY_GSM_POOL_IDLE_TIMEOUT 30000L
+#endif
+
+/*
+ * Keeps connections open after use so that the next connection to the same
+ * host and port can skip the TCP (and SSL) set up.
+ *
+ *   TinyGsmClient client0(modem, 0);
+ *   TinyGsmClient client1(modem, 1);
+ *   TinyGsmClientPool<TinyGsmClient, 2> pool;
+ *   pool.add(client0);
+ *   pool.add(client1);
+ *
+ *   TinyGsmClient* client = pool.connect(server, 80);
+ *   if (client) {
+ *     // ... make a keep-alive request and read the full response ...
+ *     pool.release(client);  // instead of client->stop()
+ *   }
+ *
+ * Secure and insecure clients go in separate pools.  Only release a client
+ * once the whole response has been read; a client with unread data is closed
+ * rather than kept.
+ */
+template <class clientType, uint8_t poolSize>
+class TinyGsmClientPool {
+ public:
+  TinyGsmClientPool()
+      : count(0),
+        idle_timeout(TINY_GSM_POOL_IDLE_TIMEOUT),
+        max_idle_per_host(1) {}
+
+  /*
+   * Pool set up
+   */
+  // Add a client (and so its mux) to the pool
+  bool add(clientType& client) {
+    if (count >= poolSize) { return false; }
+    entries[count].client = &client;
+    entries[count].state  = POOL_FREE;
+    entries[count].host   = "";
+    entries[count].port   = 0;
+    count++;
+    return true;
+  }
+
+  // How long an unused connection is kept open
+  void setIdleTimeout(uint32_t timeout_ms) {
+    idle_timeout = timeout_ms;
+  }
+
+  // How many unused connections to the same host and port are kept open
+  void setMaxIdlePerHost(uint8_t max_idle) {
+    max_idle_per_host = max_idle;
+  }
+
+  /*
+   * Connections
+   */
+  // Get a client connected to the host and port, re-using an idle connection
+  // to them if there is one.  Returns nullptr if no client could be connected.
+  clientType* connect(const char* host, uint16_t port, int timeout_s = 75) {
+    maintain();
+
+    // Re-use an idle connection to the same end point
+    for (uint8_t i = 0; i < count; i++) {
+      Entry& e = entries[i];
+      if (e.state != POOL_IDLE || e.port != port || e.host != host) {
+        continue;
+      }
+      if (!isReusable(e)) {
+        close(e);
+        continue;
+      }
+      DBG("### Pool: re-using connection on mux", e.client->mux);
+      e.state = POOL_IN_USE;
+      return e.client;
+    }
+
+    // Otherwise use a free client, or the longest idle one
+    Entry* use = nullptr;
+    for (uint8_t i = 0; i < count; i++) {
+      Entry& e = entries[i];
+      if (e.state == POOL_FREE) {
+        use = &e;
+        break;
+      }
+      if (e.state == POOL_IDLE &&
+          (use == nullptr || e.idle_since < use->idle_since)) {
+        use = &e;
+      }
+    }
+    if (use == nullptr) { return nullptr; }
+    if (use->state == POOL_IDLE) { close(*use); }
+
+    if (!use->client->connect(host, port, timeout_s)) { return nullptr; }
+    use->state = POOL_IN_USE;
+    use->host  = host;
+    use->port  = port;
+    return use->client;
+  }
+
+  // Hand a client back to the pool, keeping its connection open for re-use
+  void release(clientType* client) {
+    Entry* e = find(client);
+    if (e == nullptr || e->state != POOL_IN_USE) { return; }
+    if (!isReusable(*e) || idleCount(e->host, e->port) >= max_idle_per_host) {
+      close(*e);
+      return;
+    }
+    e->state      = POOL_IDLE;
+    e->idle_since = millis();
+  }
+
+  // Hand a client back to the pool, closing its connection
+  void close(clientType* client) {
+    Entry* e = find(client);
+    if (e != nullptr) { close(*e); }
+  }
+
+  // Close any connections that have been idle too long, or have been closed
+  // by the other end
+  void maintain() {
+    for (uint8_t i = 0; i < count; i++) {
+      Entry& e = entries[i];
+      if (e.state != POOL_IDLE) { continue; }
+      if (millis() - e.idle_since > idle_timeout || !isReusable(e)) {
+        close(e);
+      }
+    }
+  }
+
+ protected:
+  enum PoolState {
+    POOL_FREE   = 0,
+    POOL_IDLE   = 1,
+    POOL_IN_USE = 2,
+  };
+
+  struct Entry {
+    clientType* client;
+    PoolState   state;
+    String      host;
+    uint16_t    port;
+    uint32_t    idle_since;
+  };
+
+  Entry* find(clientType* client) {
+    for (uint8_t i = 0; i < count; i++) {
+      if (entries[i].client == client) { return &entries[i]; }
+    }
+    return nullptr;
+  }
+
+  // connected() processes pending URCs and only asks the modem once in a
+  // while, so this is cheap enough to call on every pass.  A connection with
+  // unread data can't be re-used.
+  bool isReusable(Entry& e) {
+    return e.client->connected() && e.client->rx.size() == 0 &&
+        e.client->sock_available == 0;
+  }
+
+  uint8_t idleCount(const String& host, uint16_t port) {
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < count; i++) {
+      if (entries[i].state == POOL_IDLE && entries[i].port == port &&
+          entries[i].host == host) {
+        n++;
+      }
+    }
+    return n;
+  }
+
+  void close(Entry& e) {
+    e.client->stop();
+    e.state = POOL_FREE;
+    e.host  = "";
+    e.port  = 0;
+  }
+
+  Entry    entries[poolSize];
+  uint8_t  count;
+  uint32_t idle_timeout;
+  uint8_t  max_idle_per_host;
+};
+
+#endif  // SRC_TINYGSMCLIENTPOOL_H_
@@ -79,6 +79,18 @@ class TinyGsmSim5360 : public TinyGsmModem<TinyGsmSim5360>,
   friend class TinyGsmBattery<TinyGsmSim5360>;
   friend class TinyGsmTemperature<TinyGsmSim5360>;
 
+  /*
+   * Socket command limits
+   */
+ public:
+  struct Traits : TinyGsmTcpTraits {
+#ifdef TINY_GSM_USE_HEX
+    static constexpr size_t maxReadSize = 750;  // two characters a byte
+#else
+    static constexpr size_t maxReadSize = 1500;
+#endif
+  };
+
   /*
    * Inner Client
    */
@@ -180,6 +192,10 @@ class TinyGsmSim5360 : public TinyGsmModem<TinyGsmSim5360>,
     sendAT(GF("+CTZU=1"));
     if (waitResponse(10000L) != 1) { return false; }
 
+    // Keep the registration and PDP context state up to date from URCs
+    enableRegistrationReports(REG_REPORT_CGREG);
+    enablePdpEvents();
+
     SimStatus ret = getSimStatus();
     // if the sim isn't ready and a pin has been provided, try to unlock the sim
     if (ret != SIM_READY && pin != nullptr && strlen(pin) > 0) {
@@ -633,7 +649,7 @@ class TinyGsmSim5360 : public TinyGsmModem<TinyGsmSim5360>,
   int16_t modemSend(const void* buff, size_t len, uint8_t mux) {
     sendAT(GF("+CIPSEND="), mux, ',', (uint16_t)len);
     if (waitResponse(GF(">")) != 1) { return 0; }
-    stream.write(reinterpret_cast<const uint8_t*>(buff), len);
+    streamWriteSendData(buff, len);
     stream.flush();
     if (waitResponse(GF(AT_NL "+CIPSEND:")) != 1) { return 0; }
     streamSkipUntil(',');  // Skip mux
@@ -657,28 +673,19 @@ class TinyGsmSim5360 : public TinyGsmModem<TinyGsmSim5360>,
     //  ^^ Requested number of data bytes (1-1460 bytes)to be read
     int16_t len_confirmed = streamGetIntBefore('\n');
     // ^^ The data length which not read in the buffer
-    for (int i = 0; i < len_requested; i++) {
-      uint32_t startMillis = millis();
 #ifdef TINY_GSM_USE_HEX
-      while (stream.available() < 2 &&
-             (millis() - startMillis < sockets[mux]->_timeout)) {
-        TINY_GSM_YIELD();
-      }
-      char buf[4] = {
-          0,
-      };
-      buf[0] = stream.read();
-      buf[1] = stream.read();
-      char c = strtol(buf, nullptr, 16);
+    moveHexFromStreamToFifo(mux, len_requested);
 #else
+    for (int i = 0; i < len_requested; i++) {
+      uint32_t startMillis = millis();
       while (!stream.available() &&
              (millis() - startMillis < sockets[mux]->_timeout)) {
         TINY_GSM_YIELD();
       }
       char c = stream.read();
-#endif
       sockets[mux]->rx.put(c);
     }
+#endif
     // DBG("### READ:", len_requested, "from", mux);
     // sockets[mux]->sock_available = modemGetAvailable(mux);
     sockets[mux]->sock_available = len_confirmed;
@@ -757,6 +764,7 @@ class TinyGsmSim5360 : public TinyGsmModem<TinyGsmSim5360>,
       // Need to close all open sockets and release the network library.
       // User will then need to reconnect.
       DBG("### Network error!");
+      pdpChanged(-1);  // Ask the module again
       if (!isGprsConnected()) { gprsDisconnect(); }
       data = "";
       return true;
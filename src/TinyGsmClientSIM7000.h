@@ -41,6 +41,18 @@ class TinyGsmSim7000 : public TinyGsmSim70xx<TinyGsmSim7000>,
   friend class TinyGsmNTP<TinyGsmSim7000>;
   friend class TinyGsmBattery<TinyGsmSim7000>;
 
+  /*
+   * Socket command limits
+   */
+ public:
+  struct Traits : TinyGsmTcpTraits {
+#ifdef TINY_GSM_USE_HEX
+    static constexpr size_t maxReadSize = 730;  // two characters a byte
+#else
+    static constexpr size_t maxReadSize = 1460;
+#endif
+  };
+
   /*
    * Inner Client
    */
@@ -143,6 +155,10 @@ class TinyGsmSim7000 : public TinyGsmSim70xx<TinyGsmSim7000>,
     sendAT(GF("+CBATCHK=1"));
     if (waitResponse() != 1) { return false; }
 
+    // Keep the registration and PDP context state up to date from URCs
+    enableRegistrationReports(REG_REPORT_CEREG | REG_REPORT_CGREG);
+    enablePdpEvents();
+
     SimStatus ret = getSimStatus();
     // if the sim isn't ready and a pin has been provided, try to unlock the sim
     if (ret != SIM_READY && pin != nullptr && strlen(pin) > 0) {
@@ -336,19 +352,22 @@ class TinyGsmSim7000 : public TinyGsmSim70xx<TinyGsmSim7000>,
     uint32_t timeout_ms = ((uint32_t)timeout_s) * 1000;
 
     // when not using SSL, the TCP application toolkit is more stable
-    sendAT(GF("+CIPSTART="), mux, ',', GF("\"TCP"), GF("\",\""), host,
+    String addr = hostToConnect(host);
+    sendAT(GF("+CIPSTART="), mux, ',', GF("\"TCP"), GF("\",\""), addr,
            GF("\","), port);
-    return (1 ==
-            waitResponse(timeout_ms, GF("CONNECT OK" AT_NL),
-                         GF("CONNECT FAIL" AT_NL), GF("ALREADY CONNECT" AT_NL),
-                         GF("ERROR" AT_NL), GF("CLOSE OK" AT_NL)));
+    int8_t rsp = waitResponse(timeout_ms, GF("CONNECT OK" AT_NL),
+                              GF("CONNECT FAIL" AT_NL),
+                              GF("ALREADY CONNECT" AT_NL), GF("ERROR" AT_NL),
+                              GF("CLOSE OK" AT_NL));
+    if (rsp != 1) { forgetHostIP(host); }
+    return (1 == rsp);
   }
 
   int16_t modemSend(const void* buff, size_t len, uint8_t mux) {
     sendAT(GF("+CIPSEND="), mux, ',', (uint16_t)len);
     if (waitResponse(GF(">")) != 1) { return 0; }
 
-    stream.write(reinterpret_cast<const uint8_t*>(buff), len);
+    streamWriteSendData(buff, len);
     stream.flush();
 
     if (waitResponse(GF(AT_NL "DATA ACCEPT:"), GF("SEND FAIL")) != 1) {
@@ -358,6 +377,10 @@ class TinyGsmSim7000 : public TinyGsmSim70xx<TinyGsmSim7000>,
     return streamGetIntBefore('\n');
   }
 
+  int16_t modemSendLast(const void* buff, size_t len, uint8_t mux) {
+    return modemSendThenCNMPSD(buff, len, mux);
+  }
+
   size_t modemRead(size_t size, uint8_t mux) {
     if (!sockets[mux]) return 0;
 
@@ -378,28 +401,19 @@ class TinyGsmSim7000 : public TinyGsmSim70xx<TinyGsmSim7000>,
     // SRGD NOTE:  Contrary to above (which is copied from AT command manual)
     // this is actually be the number of bytes that will be remaining in the
     // buffer after the read.
-    for (int i = 0; i < len_requested; i++) {
-      uint32_t startMillis = millis();
 #ifdef TINY_GSM_USE_HEX
-      while (stream.available() < 2 &&
-             (millis() - startMillis < sockets[mux]->_timeout)) {
-        TINY_GSM_YIELD();
-      }
-      char buf[4] = {
-          0,
-      };
-      buf[0] = stream.read();
-      buf[1] = stream.read();
-      char c = strtol(buf, nullptr, 16);
+    moveHexFromStreamToFifo(mux, len_requested);
 #else
+    for (int i = 0; i < len_requested; i++) {
+      uint32_t startMillis = millis();
       while (!stream.available() &&
              (millis() - startMillis < sockets[mux]->_timeout)) {
         TINY_GSM_YIELD();
       }
       char c = stream.read();
-#endif
       sockets[mux]->rx.put(c);
     }
+#endif
     // DBG("### READ:", len_requested, "from", mux);
     // sockets[mux]->sock_available = modemGetAvailable(mux);
     sockets[mux]->sock_available = len_confirmed;
@@ -497,6 +511,15 @@ class TinyGsmSim7000 : public TinyGsmSim70xx<TinyGsmSim7000>,
       DBG("### Unexpected module reset!");
       init();
       return true;
+    } else if (data.endsWith(GF("+CPSMSTATUS:"))) {
+      // +CPSMSTATUS: "ENTER PSM" or "EXIT PSM"
+      streamSkipUntil('"');
+      String status = stream.readStringUntil('"');
+      streamSkipUntil('\n');
+      psm_state = status.startsWith("ENTER") ? 1 : 0;
+      data      = "";
+      DBG("### PSM:", status);
+      return true;
     }
     return false;
   }
@@ -45,6 +45,16 @@ class TinyGsmSim7000SSL
   friend class TinyGsmTime<TinyGsmSim7000SSL>;
   friend class TinyGsmBattery<TinyGsmSim7000SSL>;
 
+  /*
+   * Socket command limits
+   */
+ public:
+  struct Traits : TinyGsmTcpTraits {
+    static constexpr size_t maxReadSize = 1460;
+    // +CARECV? lists every socket with data
+    static constexpr bool bulkAvailable = true;
+  };
+
   /*
    * Inner Client
    */
@@ -149,6 +159,9 @@ class TinyGsmSim7000SSL
 
     if (!testAT()) { return false; }
 
+    // A restart loses the SSL settings
+    ssl_config.clear();
+
     sendAT(GF("E0"));  // Echo Off
     if (waitResponse() != 1) { return false; }
 
@@ -169,6 +182,10 @@ class TinyGsmSim7000SSL
     sendAT(GF("+CBATCHK=1"));
     if (waitResponse() != 1) { return false; }
 
+    // Keep the registration and PDP context state up to date from URCs
+    enableRegistrationReports(REG_REPORT_CEREG | REG_REPORT_CGREG);
+    enablePdpEvents();
+
     SimStatus ret = getSimStatus();
     // if the sim isn't ready and a pin has been provided, try to unlock the sim
     if (ret != SIM_READY && pin != nullptr && strlen(pin) > 0) {
@@ -181,23 +198,6 @@ class TinyGsmSim7000SSL
     }
   }
 
-  void maintainImpl() {
-    // Keep listening for modem URC's and proactively iterate through
-    // sockets asking if any data is avaiable
-    bool check_socks = false;
-    for (int mux = 0; mux < TINY_GSM_MUX_COUNT; mux++) {
-      GsmClientSim7000SSL* sock = sockets[mux];
-      if (sock && sock->got_data) {
-        sock->got_data = false;
-        check_socks    = true;
-      }
-    }
-    // modemGetAvailable checks all socks, so we only want to do it once
-    // modemGetAvailable calls modemGetConnected(), which also checks allf
-    if (check_socks) { modemGetAvailable(0); }
-    while (stream.available()) { waitResponse(15, nullptr, nullptr); }
-  }
-
   /*
    * Power functions
    */
@@ -219,7 +219,26 @@ class TinyGsmSim7000SSL
   /*
    * Secure socket layer (SSL) functions
    */
-  // Follows functions as inherited from TinyGsmSSL.tpp
+ protected:
+  bool addCertificateImpl(const char* certificateName, const char* cert,
+                          const uint16_t len) {
+    TinyGsmIoVec       iov = {cert, len};
+    TinyGsmIoVecSource source(&iov, 1);
+    return addCertificateImpl(certificateName, source, len, false);
+  }
+
+  bool addCertificateImpl(const char* certificateName, TinyGsmSendSource& cert,
+                          size_t len, bool replace) {
+    if (!replace && fsFileSize(certificateName) == static_cast<int32_t>(len)) {
+      DBG("### Certificate already on the module:", certificateName);
+      return true;
+    }
+    return fsWriteFile(certificateName, cert, len);
+  }
+
+  bool deleteCertificateImpl(const char* certificateName) {
+    return fsDeleteFile(certificateName);
+  }
 
   /*
    * WiFi functions
@@ -382,8 +401,18 @@ class TinyGsmSim7000SSL
       //              4: QAPI_NET_SSL_PROTOCOL_DTLS_1_0
       //              5: QAPI_NET_SSL_PROTOCOL_DTLS_1_2
       // NOTE:  despite docs using caps, "sslversion" must be in lower case
-      sendAT(GF("+CSSLCFG=\"sslversion\",0,3"));  // TLS 1.2
-      if (waitResponse(5000L) != 1) return false;
+      // The version comes from the socket's TLS profile, TLS 1.2 unless it
+      // asks for an older one.  The settings stay in the module, so only send
+      // those that changed.
+      uint8_t version = tls_profiles[mux].version();
+      if (version == TLS_VERSION_ANY || version > TLS_VERSION_1_2) {
+        version = TLS_VERSION_1_2;
+      }
+      char version_str[2] = {static_cast<char>('0' + version), '\0'};
+      if (ssl_config.needs(0, SSL_CFG_VERSION, version_str)) {
+        sendAT(GF("+CSSLCFG=\"sslversion\",0,"), version);
+        if (!sslConfigOk()) return false;
+      }
     }
 
     // enable or disable ssl
@@ -391,8 +420,10 @@ class TinyGsmSim7000SSL
     // <cid> Application connection ID (set with AT+CACID above)
     // <sslFlag> 0: Not support SSL
     //           1: Support SSL
-    sendAT(GF("+CASSLCFG="), mux, ',', GF("ssl,"), ssl);
-    waitResponse();
+    if (ssl_config.needs(mux, SSL_CFG_ENABLED, ssl ? "1" : "0")) {
+      sendAT(GF("+CASSLCFG="), mux, ',', GF("ssl,"), ssl);
+      waitResponse();
+    }
 
     if (ssl) {
       // set the PDP context to apply SSL to
@@ -407,14 +438,15 @@ class TinyGsmSim7000SSL
       streamSkipUntil('\n');  // read out the certificate information
       waitResponse();
 
-      if (certificates[mux] != "") {
+      if (certificates[mux] != "" &&
+          ssl_config.needs(mux, SSL_CFG_CACERT, certificates[mux].c_str())) {
         // apply the correct certificate to the connection
         // AT+CASSLCFG=<cid>,"CACERT",<caname>
         // <cid> Application connection ID (set with AT+CACID above)
         // <certname> certificate name
         sendAT(GF("+CASSLCFG="), mux, ",CACERT,\"", certificates[mux].c_str(),
                "\"");
-        if (waitResponse(5000L) != 1) return false;
+        if (!sslConfigOk()) return false;
       }
 
       // set the protocol
@@ -428,8 +460,12 @@ class TinyGsmSim7000SSL
       //            use PDP context identifier of 0 for what we defined as 1 in
       //            the gprsConnect function
       // NOTE:  despite docs using caps, "sni" must be in lower case
-      sendAT(GF("+CSSLCFG=\"sni\",0,"), GF("\""), host, GF("\""));
-      waitResponse();
+      // An empty server name turns SNI off again
+      const char* sni = tls_profiles[mux].sni ? host : "";
+      if (ssl_config.needs(0, SSL_CFG_SNI, sni)) {
+        sendAT(GF("+CSSLCFG=\"sni\",0,"), GF("\""), sni, GF("\""));
+        waitResponse();
+      }
     }
 
     // actually open the connection
@@ -437,8 +473,12 @@ class TinyGsmSim7000SSL
     // <cid> TCP/UDP identifier
     // <conn_type> "TCP" or "UDP"
     // NOTE:  the "TCP" can't be included
-    sendAT(GF("+CAOPEN="), mux, GF(",\""), host, GF("\","), port);
-    if (waitResponse(timeout_ms, GF(AT_NL "+CAOPEN:")) != 1) { return 0; }
+    String addr = hostToConnect(host, ssl);
+    sendAT(GF("+CAOPEN="), mux, GF(",\""), addr, GF("\","), port);
+    if (waitResponse(timeout_ms, GF(AT_NL "+CAOPEN:")) != 1) {
+      forgetHostIP(host);
+      return 0;
+    }
     // returns OK/r/n/r/n+CAOPEN: <cid>,<result>
     // <result> 0: Success
     //          1: Socket error
@@ -462,15 +502,24 @@ class TinyGsmSim7000SSL
     int8_t res = streamGetIntBefore('\n');
     waitResponse();
 
+    if (res != 0) { forgetHostIP(host); }
     return 0 == res;
   }
 
+  // Waits for the result of an SSL setting, forgetting the applied settings if
+  // it fails
+  bool sslConfigOk() {
+    if (waitResponse(5000L) == 1) { return true; }
+    ssl_config.clear();
+    return false;
+  }
+
   int16_t modemSend(const void* buff, size_t len, uint8_t mux) {
     // send data on prompt
     sendAT(GF("+CASEND="), mux, ',', (uint16_t)len);
     if (waitResponse(GF(">")) != 1) { return 0; }
 
-    stream.write(reinterpret_cast<const uint8_t*>(buff), len);
+    streamWriteSendData(buff, len);
     stream.flush();
 
     // after posting data, module responds with:
@@ -481,6 +530,10 @@ class TinyGsmSim7000SSL
     return streamGetIntBefore('\n');
   }
 
+  int16_t modemSendLast(const void* buff, size_t len, uint8_t mux) {
+    return modemSendThenCNMPSD(buff, len, mux);
+  }
+
   size_t modemRead(size_t size, uint8_t mux) {
     if (!sockets[mux]) { return 0; }
 
@@ -688,12 +741,23 @@ class TinyGsmSim7000SSL
       DBG("### Unexpected module reset!");
       init();
       return true;
+    } else if (data.endsWith(GF("+CPSMSTATUS:"))) {
+      // +CPSMSTATUS: "ENTER PSM" or "EXIT PSM"
+      streamSkipUntil('"');
+      String status = stream.readStringUntil('"');
+      streamSkipUntil('\n');
+      psm_state = status.startsWith("ENTER") ? 1 : 0;
+      data      = "";
+      DBG("### PSM:", status);
+      return true;
     }
     return false;
   }
 
  protected:
   GsmClientSim7000SSL* sockets[TINY_GSM_MUX_COUNT];
+  // SSL context 0 is shared; the per connection settings are kept by mux
+  TinyGsmSSLConfigCache<TINY_GSM_MUX_COUNT> ssl_config;
 };
 
 #endif  // SRC_TINYGSMCLIENTSIM7000SSL_H_
@@ -44,6 +44,16 @@ class TinyGsmSim7080 : public TinyGsmSim70xx<TinyGsmSim7080>,
   friend class TinyGsmNTP<TinyGsmSim7080>;
   friend class TinyGsmBattery<TinyGsmSim7080>;
 
+  /*
+   * Socket command limits
+   */
+ public:
+  struct Traits : TinyGsmTcpTraits {
+    static constexpr size_t maxReadSize = 1460;
+    // +CARECV? lists every socket with data
+    static constexpr bool bulkAvailable = true;
+  };
+
   /*
    * Inner Client
    */
@@ -52,9 +62,12 @@ class TinyGsmSim7080 : public TinyGsmSim70xx<TinyGsmSim7080>,
     friend class TinyGsmSim7080;
 
    public:
-    GsmClientSim7080() {}
+    GsmClientSim7080() {
+      ssl_sock = false;
+    }
 
     explicit GsmClientSim7080(TinyGsmSim7080& modem, uint8_t mux = 0) {
+      ssl_sock = false;
       init(&modem, mux);
     }
 
@@ -100,6 +113,9 @@ class TinyGsmSim7080 : public TinyGsmSim70xx<TinyGsmSim7080>,
      */
 
     String remoteIP() TINY_GSM_ATTR_NOT_IMPLEMENTED;
+
+   protected:
+    bool ssl_sock;
   };
 
   /*
@@ -108,10 +124,14 @@ class TinyGsmSim7080 : public TinyGsmSim70xx<TinyGsmSim7080>,
  public:
   class GsmClientSecureSIM7080 : public GsmClientSim7080 {
    public:
-    GsmClientSecureSIM7080() {}
+    GsmClientSecureSIM7080() {
+      ssl_sock = true;
+    }
 
     explicit GsmClientSecureSIM7080(TinyGsmSim7080& modem, uint8_t mux = 0)
-        : GsmClientSim7080(modem, mux) {}
+        : GsmClientSim7080(modem, mux) {
+      ssl_sock = true;
+    }
 
     bool setCertificate(const String& certificateName) {
       return at->setCertificate(certificateName, mux);
@@ -144,6 +164,9 @@ class TinyGsmSim7080 : public TinyGsmSim70xx<TinyGsmSim7080>,
     DBG(GF("### TinyGSM Version:"), TINYGSM_VERSION);
     DBG(GF("### TinyGSM Compiled Module:  TinyGsmClientSIM7080"));
 
+    // A restart loses the SSL settings
+    ssl_config.clear();
+
     bool gotATOK = false;
     for (uint32_t start = millis(); millis() - start < 10000L;) {
       sendAT(GF(""));
@@ -178,6 +201,10 @@ class TinyGsmSim7080 : public TinyGsmSim70xx<TinyGsmSim7080>,
     sendAT(GF("+CBATCHK=1"));
     if (waitResponse() != 1) { return false; }
 
+    // Keep the registration and PDP context state up to date from URCs
+    enableRegistrationReports(REG_REPORT_CEREG | REG_REPORT_CGREG);
+    enablePdpEvents();
+
     SimStatus ret = getSimStatus();
     // if the sim isn't ready and a pin has been provided, try to unlock the sim
     if (ret != SIM_READY && pin != nullptr && strlen(pin) > 0) {
@@ -190,23 +217,6 @@ class TinyGsmSim7080 : public TinyGsmSim70xx<TinyGsmSim7080>,
     }
   }
 
-  void maintainImpl() {
-    // Keep listening for modem URC's and proactively iterate through
-    // sockets asking if any data is avaiable
-    bool check_socks = false;
-    for (int mux = 0; mux < TINY_GSM_MUX_COUNT; mux++) {
-      GsmClientSim7080* sock = sockets[mux];
-      if (sock && sock->got_data) {
-        sock->got_data = false;
-        check_socks    = true;
-      }
-    }
-    // modemGetAvailable checks all socks, so we only want to do it once
-    // modemGetAvailable calls modemGetConnected(), which also checks allf
-    if (check_socks) { modemGetAvailable(0); }
-    while (stream.available()) { waitResponse(15, nullptr, nullptr); }
-  }
-
   /*
    * Power functions
    */
@@ -254,7 +264,26 @@ class TinyGsmSim7080 : public TinyGsmSim70xx<TinyGsmSim7080>,
   /*
    * Secure socket layer (SSL) functions
    */
-  // Follows functions as inherited from TinyGsmSSL.tpp
+ protected:
+  bool addCertificateImpl(const char* certificateName, const char* cert,
+                          const uint16_t len) {
+    TinyGsmIoVec       iov = {cert, len};
+    TinyGsmIoVecSource source(&iov, 1);
+    return addCertificateImpl(certificateName, source, len, false);
+  }
+
+  bool addCertificateImpl(const char* certificateName, TinyGsmSendSource& cert,
+                          size_t len, bool replace) {
+    if (!replace && fsFileSize(certificateName) == static_cast<int32_t>(len)) {
+      DBG("### Certificate already on the module:", certificateName);
+      return true;
+    }
+    return fsWriteFile(certificateName, cert, len);
+  }
+
+  bool deleteCertificateImpl(const char* certificateName) {
+    return fsDeleteFile(certificateName);
+  }
 
   /*
    * WiFi functions
@@ -463,8 +492,18 @@ class TinyGsmSim7080 : public TinyGsmSim70xx<TinyGsmSim7080>,
       //              4: QAPI_NET_SSL_PROTOCOL_DTLS_1_0
       //              5: QAPI_NET_SSL_PROTOCOL_DTLS_1_2
       // NOTE:  despite docs using caps, "sslversion" must be in lower case
-      sendAT(GF("+CSSLCFG=\"sslversion\",0,3"));  // TLS 1.2
-      if (waitResponse(5000L) != 1) return false;
+      // The version comes from the socket's TLS profile, TLS 1.2 unless it
+      // asks for an older one.  The settings stay in the module, so only send
+      // those that changed.
+      uint8_t version = tls_profiles[mux].version();
+      if (version == TLS_VERSION_ANY || version > TLS_VERSION_1_2) {
+        version = TLS_VERSION_1_2;
+      }
+      char version_str[2] = {static_cast<char>('0' + version), '\0'};
+      if (ssl_config.needs(0, SSL_CFG_VERSION, version_str)) {
+        sendAT(GF("+CSSLCFG=\"sslversion\",0,"), version);
+        if (!sslConfigOk()) return false;
+      }
     }
 
     // enable or disable ssl
@@ -472,8 +511,10 @@ class TinyGsmSim7080 : public TinyGsmSim70xx<TinyGsmSim7080>,
     // <cid> Application connection ID (set with AT+CACID above)
     // <sslFlag> 0: Not support SSL
     //           1: Support SSL
-    sendAT(GF("+CASSLCFG="), mux, ',', GF("SSL,"), ssl);
-    waitResponse();
+    if (ssl_config.needs(mux, SSL_CFG_ENABLED, ssl ? "1" : "0")) {
+      sendAT(GF("+CASSLCFG="), mux, ',', GF("SSL,"), ssl);
+      waitResponse();
+    }
 
     if (ssl) {
       // set the PDP context to apply SSL to
@@ -488,14 +529,15 @@ class TinyGsmSim7080 : public TinyGsmSim70xx<TinyGsmSim7080>,
       streamSkipUntil('\n');  // read out the certificate information
       waitResponse();
 
-      if (certificates[mux] != "") {
+      if (certificates[mux] != "" &&
+          ssl_config.needs(mux, SSL_CFG_CACERT, certificates[mux].c_str())) {
         // apply the correct certificate to the connection
         // AT+CASSLCFG=<cid>,"CACERT",<caname>
         // <cid> Application connection ID (set with AT+CACID above)
         // <certname> certificate name
         sendAT(GF("+CASSLCFG="), mux, ",CACERT,\"", certificates[mux].c_str(),
                "\"");
-        if (waitResponse(5000L) != 1) return false;
+        if (!sslConfigOk()) return false;
       }
 
       // set the SSL SNI (server name indication)
@@ -504,8 +546,12 @@ class TinyGsmSim7080 : public TinyGsmSim70xx<TinyGsmSim7080>,
       //            use PDP context identifier of 0 for what we defined as 1 in
       //            the gprsConnect function
       // NOTE:  despite docs using caps, "sni" must be in lower case
-      sendAT(GF("+CSSLCFG=\"sni\",0,"), GF("\""), host, GF("\""));
-      waitResponse();
+      // An empty server name turns SNI off again
+      const char* sni = tls_profiles[mux].sni ? host : "";
+      if (ssl_config.needs(0, SSL_CFG_SNI, sni)) {
+        sendAT(GF("+CSSLCFG=\"sni\",0,"), GF("\""), sni, GF("\""));
+        waitResponse();
+      }
     }
 
     // actually open the connection
@@ -520,8 +566,12 @@ class TinyGsmSim7080 : public TinyGsmSim70xx<TinyGsmSim7080>,
     //                +CAURC:
     //                "recv",<id>,<length>,<remoteIP>,<remote_port><CR><LF><data>
     // NOTE:  including the <recv_mode> fails
-    sendAT(GF("+CAOPEN="), mux, GF(",0,\"TCP\",\""), host, GF("\","), port);
-    if (waitResponse(timeout_ms, GF(AT_NL "+CAOPEN:")) != 1) { return 0; }
+    String addr = hostToConnect(host, ssl);
+    sendAT(GF("+CAOPEN="), mux, GF(",0,\"TCP\",\""), addr, GF("\","), port);
+    if (waitResponse(timeout_ms, GF(AT_NL "+CAOPEN:")) != 1) {
+      forgetHostIP(host);
+      return 0;
+    }
     // returns OK/r/n/r/n+CAOPEN: <cid>,<result>
     // <result> 0: Success
     //          1: Socket error
@@ -545,15 +595,53 @@ class TinyGsmSim7080 : public TinyGsmSim70xx<TinyGsmSim7080>,
     int8_t res = streamGetIntBefore('\n');
     waitResponse();
 
+    if (res != 0) { forgetHostIP(host); }
     return 0 == res;
   }
 
+  // Sends the open command for a plain TCP connection, leaving the +CAOPEN
+  // result to handleURCs.  Depending on the firmware the result comes before
+  // or after the OK; in the first case the opens will run one at a time.
+  bool modemBeginConnect(const char* host, uint16_t port, uint8_t mux,
+                         int timeout_s) {
+    if (sockets[mux]->ssl_sock) {
+      DBG("### SSL sockets must be connected one at a time");
+      return false;
+    }
+    uint32_t timeout_ms = ((uint32_t)timeout_s) * 1000;
+    sendAT(GF("+CACID="), mux);
+    if (waitResponse(timeout_ms) != 1) return false;
+    if (ssl_config.needs(mux, SSL_CFG_ENABLED, "0")) {
+      sendAT(GF("+CASSLCFG="), mux, ',', GF("SSL,0"));
+      waitResponse();
+    }
+
+    String addr = hostToConnect(host);
+    sendAT(GF("+CAOPEN="), mux, GF(",0,\"TCP\",\""), addr, GF("\","), port);
+    return waitResponse(timeout_ms) == 1;
+  }
+
+  template <class clientType>
+  uint8_t connectManyImpl(clientType* clients[], const char* const hosts[],
+                          const uint16_t ports[], uint8_t count,
+                          int timeout_s) {
+    return connectManyConcurrent(clients, hosts, ports, count, timeout_s);
+  }
+
+  // Waits for the result of an SSL setting, forgetting the applied settings if
+  // it fails
+  bool sslConfigOk() {
+    if (waitResponse(5000L) == 1) { return true; }
+    ssl_config.clear();
+    return false;
+  }
+
   int16_t modemSend(const void* buff, size_t len, uint8_t mux) {
     // send data on prompt
     sendAT(GF("+CASEND="), mux, ',', (uint16_t)len);
     if (waitResponse(GF(">")) != 1) { return 0; }
 
-    stream.write(reinterpret_cast<const uint8_t*>(buff), len);
+    streamWriteSendData(buff, len);
     stream.flush();
 
     // OK after posting data
@@ -562,6 +650,10 @@ class TinyGsmSim7080 : public TinyGsmSim70xx<TinyGsmSim7080>,
     return len;
   }
 
+  int16_t modemSendLast(const void* buff, size_t len, uint8_t mux) {
+    return modemSendThenCNMPSD(buff, len, mux);
+  }
+
   size_t modemRead(size_t size, uint8_t mux) {
     if (!sockets[mux]) { return 0; }
 
@@ -737,6 +829,19 @@ class TinyGsmSim7080 : public TinyGsmSim70xx<TinyGsmSim7080>,
       }
       data = "";
       return true;
+    } else if (data.endsWith(GF("+CAOPEN:"))) {
+      // The result of an open from connectMany()
+      int8_t mux = streamGetIntBefore(',');
+      int8_t res = streamGetIntBefore('\n');
+      // A late result for an open that already timed out is ignored
+      if (mux >= 0 && mux < TINY_GSM_MUX_COUNT && sockets[mux] &&
+          sockets[mux]->sock_opening) {
+        sockets[mux]->sock_connected = (res == 0);
+        sockets[mux]->sock_opening   = false;
+      }
+      data = "";
+      DBG("### Opened:", mux, res);
+      return true;
     } else if (data.endsWith(GF("*PSNWID:"))) {
       streamSkipUntil('\n');  // Refresh network name by network
       data = "";
@@ -763,13 +868,23 @@ class TinyGsmSim7080 : public TinyGsmSim70xx<TinyGsmSim7080>,
       init();
       data = "";
       return true;
+    } else if (data.endsWith(GF("+CPSMSTATUS:"))) {
+      // +CPSMSTATUS: "ENTER PSM" or "EXIT PSM"
+      streamSkipUntil('"');
+      String status = stream.readStringUntil('"');
+      streamSkipUntil('\n');
+      psm_state = status.startsWith("ENTER") ? 1 : 0;
+      data      = "";
+      DBG("### PSM:", status);
+      return true;
     }
     return false;
   }
 
  protected:
   GsmClientSim7080* sockets[TINY_GSM_MUX_COUNT];
-  String            certificates[TINY_GSM_MUX_COUNT];
+  // SSL context 0 is shared; the per connection settings are kept by mux
+  TinyGsmSSLConfigCache<TINY_GSM_MUX_COUNT> ssl_config;
 };
 
 #endif  // SRC_TINYGSMCLIENTSIM7080_H_
@@ -11,6 +11,7 @@
 
 // #define TINY_GSM_DEBUG Serial
 // #define TINY_GSM_USE_HEX
+// #define TINY_GSM_USE_DNS_CACHE
 #ifdef AT_NL
 #undef AT_NL
 #endif
@@ -39,6 +40,9 @@
 #include "TinyGsmModem.tpp"
 #include "TinyGsmGPRS.tpp"
 #include "TinyGsmGPS.tpp"
+#include "TinyGsmDNS.tpp"
+#include "TinyGsmPowerSave.tpp"
+#include "TinyGsmTCP.tpp"
 
 enum SIM70xxRegStatus {
   REG_NO_RESULT    = -1,
@@ -53,10 +57,14 @@ enum SIM70xxRegStatus {
 template <class SIM70xxType>
 class TinyGsmSim70xx : public TinyGsmModem<SIM70xxType>,
                        public TinyGsmGPRS<SIM70xxType>,
-                       public TinyGsmGPS<SIM70xxType> {
+                       public TinyGsmGPS<SIM70xxType>,
+                       public TinyGsmDNS<SIM70xxType>,
+                       public TinyGsmPowerSave<SIM70xxType> {
   friend class TinyGsmModem<SIM70xxType>;
   friend class TinyGsmGPRS<SIM70xxType>;
   friend class TinyGsmGPS<SIM70xxType>;
+  friend class TinyGsmDNS<SIM70xxType>;
+  friend class TinyGsmPowerSave<SIM70xxType>;
 
   /*
    * CRTP Helper
@@ -116,6 +124,28 @@ class TinyGsmSim70xx : public TinyGsmModem<SIM70xxType>,
     return thisModem().waitResponse(10000L) == 1;
   }
 
+  /*
+   * Power saving mode (PSM) and eDRX functions
+   */
+ protected:
+  bool psmReportsImpl(bool enable) {
+    // +CPSMSTATUS on entering and leaving PSM
+    thisModem().sendAT(GF("+CPSMSTATUS="), enable);
+    return thisModem().waitResponse() == 1;
+  }
+
+  // AT+CPTWEDRXS sets the paging time window along with the cycle
+  bool setEDRXImpl(bool enable, EDRXAct act, EDRXCycle cycle, int8_t ptw) {
+    typedef TinyGsmPowerSave<SIM70xxType> PowerSave;
+    if (!enable || ptw < 0) {
+      return PowerSave::setEDRXImpl(enable, act, cycle, ptw);
+    }
+    thisModem().sendAT(GF("+CPTWEDRXS=1,"), act, ',',
+                       PowerSave::quoted(PowerSave::bitString(ptw, 4)), ',',
+                       PowerSave::quoted(PowerSave::bitString(cycle, 4)));
+    return thisModem().waitResponse() == 1;
+  }
+
   /*
    * Generic network functions
    */
@@ -214,6 +244,105 @@ class TinyGsmSim70xx : public TinyGsmModem<SIM70xxType>,
  protected:
   // should implement in sub-classes
 
+  /*
+   * Fast attach functions
+   */
+ protected:
+  // Reads the band from AT+CPSI, ie:
+  // LTE CAT-M1,Online,262-01,0x1816,27447553,257,EUTRAN-BAND20,6300,...
+  uint16_t getServingBandImpl() {
+    thisModem().sendAT(GF("+CPSI?"));
+    if (thisModem().waitResponse(GF("+CPSI:")) != 1) { return 0; }
+    String line = stream.readStringUntil('\n');
+    thisModem().waitResponse();
+    int band = line.indexOf("BAND");
+    return band < 0 ? 0 : line.substring(band + 4).toInt();
+  }
+
+  /*
+   * File system functions
+   */
+ protected:
+  // Writes a file into the "customer" directory (3), ie, a certificate for the
+  // SSL capable modules, in pieces of at most 10240 bytes, the largest single
+  // write the module takes
+  bool fsWriteFile(const char* filename, TinyGsmSendSource& data, size_t len) {
+    thisModem().sendAT(GF("+CFSINIT"));
+    thisModem().waitResponse();
+
+    bool   success = true;
+    size_t done    = 0;
+    do {
+      size_t chunk = TinyGsmMin(len - done, static_cast<size_t>(10240));
+      // AT+CFSWFILE=<index>,<filename>,<mode>,<filesize>,<inputtime>
+      // <mode> 0: overwrite, 1: append
+      thisModem().sendAT(GF("+CFSWFILE=3,\""), filename, GF("\","),
+                         done ? 1 : 0, ',', chunk, GF(",10000"));
+      success = thisModem().waitResponse(10000L, GF("DOWNLOAD")) == 1;
+      if (success) {
+        thisModem().send_source = &data;
+        thisModem().streamWriteSendData(nullptr, chunk);
+        thisModem().send_source = nullptr;
+        success = thisModem().waitResponse(10000L) == 1;
+      }
+      done += chunk;
+    } while (success && done < len);
+
+    thisModem().sendAT(GF("+CFSTERM"));
+    thisModem().waitResponse();
+    return success;
+  }
+
+  bool fsDeleteFile(const char* filename) {
+    thisModem().sendAT(GF("+CFSINIT"));
+    thisModem().waitResponse();
+    thisModem().sendAT(GF("+CFSDFILE=3,\""), filename, '"');
+    bool success = thisModem().waitResponse() == 1;
+    thisModem().sendAT(GF("+CFSTERM"));
+    thisModem().waitResponse();
+    return success;
+  }
+
+  // The size of a file in the "customer" directory, or -1 if there's no such
+  // file
+  int32_t fsFileSize(const char* filename) {
+    thisModem().sendAT(GF("+CFSINIT"));
+    thisModem().waitResponse();
+    thisModem().sendAT(GF("+CFSGFIS=3,\""), filename, '"');
+    int32_t size = -1;
+    if (thisModem().waitResponse(GF("+CFSGFIS:")) == 1) {
+      size = thisModem().streamGetIntBefore('\n');
+      thisModem().waitResponse();
+    }
+    thisModem().sendAT(GF("+CFSTERM"));
+    thisModem().waitResponse();
+    return size;
+  }
+
+  /*
+   * DNS functions
+   */
+ protected:
+  bool dnsLookupImpl(const char* host, String& ip, uint32_t&) {
+    // The result comes after the OK as +CDNSGIP: 1,"<host>","<ip>"[,"<ip2>"]
+    // or +CDNSGIP: 0,<error>
+    thisModem().sendAT(GF("+CDNSGIP=\""), host, '"');
+    if (thisModem().waitResponse() != 1) { return false; }
+    if (thisModem().waitResponse(30000L, GF("+CDNSGIP:")) != 1) {
+      return false;
+    }
+    if (thisModem().streamGetIntBefore(',') != 1) {
+      thisModem().streamSkipUntil('\n');
+      return false;
+    }
+    thisModem().streamSkipUntil('"');  // Skip the host
+    thisModem().streamSkipUntil('"');
+    thisModem().streamSkipUntil('"');
+    ip = stream.readStringUntil('"');
+    thisModem().streamSkipUntil('\n');
+    return true;
+  }
+
   /*
    * SIM card functions
    */
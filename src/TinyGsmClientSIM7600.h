@@ -11,6 +11,7 @@
 
 // #define TINY_GSM_DEBUG Serial
 // #define TINY_GSM_USE_HEX
+// #define TINY_GSM_USE_DNS_CACHE
 
 #define TINY_GSM_MUX_COUNT 10
 #define TINY_GSM_BUFFER_READ_AND_CHECK_SIZE
@@ -44,6 +45,7 @@
 #include "TinyGsmGPS.tpp"
 #include "TinyGsmTime.tpp"
 #include "TinyGsmNTP.tpp"
+#include "TinyGsmDNS.tpp"
 #include "TinyGsmBattery.tpp"
 #include "TinyGsmTemperature.tpp"
 
@@ -68,7 +70,8 @@ class TinyGsmSim7600 : public TinyGsmModem<TinyGsmSim7600>,
                        public TinyGsmNTP<TinyGsmSim7600>,
                        public TinyGsmBattery<TinyGsmSim7600>,
                        public TinyGsmTemperature<TinyGsmSim7600>,
-                       public TinyGsmCalling<TinyGsmSim7600> {
+                       public TinyGsmCalling<TinyGsmSim7600>,
+                       public TinyGsmDNS<TinyGsmSim7600> {
   friend class TinyGsmModem<TinyGsmSim7600>;
   friend class TinyGsmGPRS<TinyGsmSim7600>;
   friend class TinyGsmTCP<TinyGsmSim7600, TINY_GSM_MUX_COUNT>;
@@ -80,6 +83,19 @@ class TinyGsmSim7600 : public TinyGsmModem<TinyGsmSim7600>,
   friend class TinyGsmBattery<TinyGsmSim7600>;
   friend class TinyGsmTemperature<TinyGsmSim7600>;
   friend class TinyGsmCalling<TinyGsmSim7600>;
+  friend class TinyGsmDNS<TinyGsmSim7600>;
+
+  /*
+   * Socket command limits
+   */
+ public:
+  struct Traits : TinyGsmTcpTraits {
+#ifdef TINY_GSM_USE_HEX
+    static constexpr size_t maxReadSize = 750;  // two characters a byte
+#else
+    static constexpr size_t maxReadSize = 1500;
+#endif
+  };
 
   /*
    * Inner Client
@@ -182,6 +198,10 @@ class TinyGsmSim7600 : public TinyGsmModem<TinyGsmSim7600>,
     sendAT(GF("+CTZU=1"));
     if (waitResponse(10000L) != 1) { return false; }
 
+    // Keep the registration and PDP context state up to date from URCs
+    enableRegistrationReports(REG_REPORT_CGREG);
+    enablePdpEvents();
+
     SimStatus ret = getSimStatus();
     // if the sim isn't ready and a pin has been provided, try to unlock the sim
     if (ret != SIM_READY && pin != nullptr && strlen(pin) > 0) {
@@ -206,7 +226,8 @@ class TinyGsmSim7600 : public TinyGsmModem<TinyGsmSim7600>,
     if (!testAT()) { return false; }
     sendAT(GF("+CRESET"));
     if (waitResponse(10000L) != 1) { return false; }
-    delay(24000L);
+    // The last of the start up URCs
+    waitResponse(24000L, GF("PB DONE"));
     return init(pin);
   }
 
@@ -398,6 +419,41 @@ class TinyGsmSim7600 : public TinyGsmModem<TinyGsmSim7600>,
     return res;
   }
 
+  /*
+   * Fast attach functions
+   */
+ protected:
+  // Reads the band from AT+CPSI, ie:
+  // LTE,Online,460-11,0x5A1E,187214780,257,EUTRAN-BAND3,1825,...
+  uint16_t getServingBandImpl() {
+    sendAT(GF("+CPSI?"));
+    if (waitResponse(GF("+CPSI:")) != 1) { return 0; }
+    String line = stream.readStringUntil('\n');
+    waitResponse();
+    int band = line.indexOf("BAND");
+    return band < 0 ? 0 : line.substring(band + 4).toInt();
+  }
+
+  /*
+   * DNS functions
+   */
+ protected:
+  bool dnsLookupImpl(const char* host, String& ip, uint32_t&) {
+    // +CDNSGIP: 1,"<host>","<ip>"[,"<ip2>"] or +CDNSGIP: 0,<error>
+    sendAT(GF("+CDNSGIP=\""), host, '"');
+    if (waitResponse(30000L, GF("+CDNSGIP:")) != 1) { return false; }
+    if (streamGetIntBefore(',') != 1) {
+      waitResponse();
+      return false;
+    }
+    streamSkipUntil('"');  // Skip the host
+    streamSkipUntil('"');
+    streamSkipUntil('"');
+    ip = stream.readStringUntil('"');
+    waitResponse();
+    return true;
+  }
+
   /*
    * SIM card functions
    */
@@ -637,27 +693,53 @@ class TinyGsmSim7600 : public TinyGsmModem<TinyGsmSim7600>,
   bool modemConnect(const char* host, uint16_t port, uint8_t mux,
                     bool ssl = false, int timeout_s = 15) {
     if (ssl) { DBG("SSL not yet supported on this module!"); }
+    if (!modemBeginConnect(host, port, mux, timeout_s)) {
+      forgetHostIP(host);
+      return false;
+    }
+
+    uint32_t timeout_ms = ((uint32_t)timeout_s) * 1000;
+    if (waitResponse(timeout_ms, GF(AT_NL "+CIPOPEN:")) != 1) {
+      forgetHostIP(host);
+      return false;
+    }
+    uint8_t opened_mux    = streamGetIntBefore(',');
+    uint8_t opened_result = streamGetIntBefore('\n');
+    if (opened_mux != mux || opened_result != 0) {
+      forgetHostIP(host);
+      return false;
+    }
+    return true;
+  }
+
+  // Sends the open command, leaving the +CIPOPEN result to the caller or to
+  // handleURCs
+  bool modemBeginConnect(const char* host, uint16_t port, uint8_t mux, int) {
     // Make sure we'll be getting data manually on this connection
     sendAT(GF("+CIPRXGET=1"));
     if (waitResponse() != 1) { return false; }
 
     // Establish a connection in multi-socket mode
-    uint32_t timeout_ms = ((uint32_t)timeout_s) * 1000;
-    sendAT(GF("+CIPOPEN="), mux, ',', GF("\"TCP"), GF("\",\""), host, GF("\","),
+    String addr = hostToConnect(host);
+    sendAT(GF("+CIPOPEN="), mux, ',', GF("\"TCP"), GF("\",\""), addr, GF("\","),
            port);
     // The reply is OK followed by +CIPOPEN: <link_num>,<err> where <link_num>
     // is the mux number and <err> should be 0 if there's no error
-    if (waitResponse(timeout_ms, GF(AT_NL "+CIPOPEN:")) != 1) { return false; }
-    uint8_t opened_mux    = streamGetIntBefore(',');
-    uint8_t opened_result = streamGetIntBefore('\n');
-    if (opened_mux != mux || opened_result != 0) return false;
-    return true;
+    return waitResponse() == 1;
+  }
+
+  // The module takes several CIPOPEN commands before the first one completes
+  template <class clientType>
+  uint8_t connectManyImpl(clientType* clients[], const char* const hosts[],
+                          const uint16_t ports[], uint8_t count,
+                          int timeout_s) {
+    return connectManyConcurrent(clients, hosts, ports, count, timeout_s);
   }
 
   int16_t modemSend(const void* buff, size_t len, uint8_t mux) {
     sendAT(GF("+CIPSEND="), mux, ',', (uint16_t)len);
     if (waitResponse(GF(">")) != 1) { return 0; }
-    stream.write(reinterpret_cast<const uint8_t*>(buff), len);
+    streamWriteSendData(buff, len);
     stream.flush();
     if (waitResponse(GF(AT_NL "+CIPSEND:")) != 1) { return 0; }
     streamSkipUntil(',');  // Skip mux
@@ -681,28 +763,19 @@ class TinyGsmSim7600 : public TinyGsmModem<TinyGsmSim7600>,
     //  ^^ Requested number of data bytes (1-1460 bytes)to be read
     int16_t len_confirmed = streamGetIntBefore('\n');
     // ^^ The data length which not read in the buffer
-    for (int i = 0; i < len_requested; i++) {
-      uint32_t startMillis = millis();
 #ifdef TINY_GSM_USE_HEX
-      while (stream.available() < 2 &&
-             (millis() - startMillis < sockets[mux]->_timeout)) {
-        TINY_GSM_YIELD();
-      }
-      char buf[4] = {
-          0,
-      };
-      buf[0] = stream.read();
-      buf[1] = stream.read();
-      char c = strtol(buf, nullptr, 16);
+    moveHexFromStreamToFifo(mux, len_requested);
 #else
+    for (int i = 0; i < len_requested; i++) {
+      uint32_t startMillis = millis();
       while (!stream.available() &&
              (millis() - startMillis < sockets[mux]->_timeout)) {
         TINY_GSM_YIELD();
       }
       char c = stream.read();
-#endif
       sockets[mux]->rx.put(c);
     }
+#endif
     // DBG("### READ:", len_requested, "from", mux);
     // sockets[mux]->sock_available = modemGetAvailable(mux);
     sockets[mux]->sock_available = len_confirmed;
@@ -779,10 +852,24 @@ class TinyGsmSim7600 : public TinyGsmModem<TinyGsmSim7600>,
       data = "";
       DBG("### Closed: ", mux);
       return true;
+    } else if (data.endsWith(GF(AT_NL "+CIPOPEN:"))) {
+      // The result of an open from connectMany()
+      int8_t mux = streamGetIntBefore(',');
+      int8_t err = streamGetIntBefore('\n');
+      // A late result for an open that already timed out is ignored
+      if (mux >= 0 && mux < TINY_GSM_MUX_COUNT && sockets[mux] &&
+          sockets[mux]->sock_opening) {
+        sockets[mux]->sock_connected = (err == 0);
+        sockets[mux]->sock_opening   = false;
+      }
+      data = "";
+      DBG("### Opened:", mux, err);
+      return true;
     } else if (data.endsWith(GF("+CIPEVENT:"))) {
       // Need to close all open sockets and release the network library.
       // User will then need to reconnect.
       DBG("### Network error!");
+      pdpChanged(-1);  // Ask the module again
       if (!isGprsConnected()) { gprsDisconnect(); }
       data = "";
       return true;
@@ -12,8 +12,12 @@
 
 // #define TINY_GSM_DEBUG Serial
 // #define TINY_GSM_USE_HEX
+// #define TINY_GSM_USE_DNS_CACHE
 
 #define TINY_GSM_MUX_COUNT 5
+#if !defined(TINY_GSM_SEND_MAX_SIZE)
+#define TINY_GSM_SEND_MAX_SIZE 1460
+#endif
 #define TINY_GSM_BUFFER_READ_AND_CHECK_SIZE
 #ifdef AT_NL
 #undef AT_NL
@@ -47,6 +51,7 @@
 #include "TinyGsmGSMLocation.tpp"
 #include "TinyGsmTime.tpp"
 #include "TinyGsmNTP.tpp"
+#include "TinyGsmDNS.tpp"
 #include "TinyGsmBattery.tpp"
 
 enum SIM800RegStatus {
@@ -67,7 +72,8 @@ class TinyGsmSim800 : public TinyGsmModem<TinyGsmSim800>,
                       public TinyGsmGSMLocation<TinyGsmSim800>,
                       public TinyGsmTime<TinyGsmSim800>,
                       public TinyGsmNTP<TinyGsmSim800>,
-                      public TinyGsmBattery<TinyGsmSim800> {
+                      public TinyGsmBattery<TinyGsmSim800>,
+                      public TinyGsmDNS<TinyGsmSim800> {
   friend class TinyGsmModem<TinyGsmSim800>;
   friend class TinyGsmGPRS<TinyGsmSim800>;
   friend class TinyGsmTCP<TinyGsmSim800, TINY_GSM_MUX_COUNT>;
@@ -78,6 +84,19 @@ class TinyGsmSim800 : public TinyGsmModem<TinyGsmSim800>,
   friend class TinyGsmTime<TinyGsmSim800>;
   friend class TinyGsmNTP<TinyGsmSim800>;
   friend class TinyGsmBattery<TinyGsmSim800>;
+  friend class TinyGsmDNS<TinyGsmSim800>;
+
+  /*
+   * Socket command limits
+   */
+ public:
+  struct Traits : TinyGsmTcpTraits {
+#ifdef TINY_GSM_USE_HEX
+    static constexpr size_t maxReadSize = 730;  // two characters a byte
+#else
+    static constexpr size_t maxReadSize = 1460;
+#endif
+  };
 
   /*
    * Inner Client
@@ -199,6 +218,10 @@ class TinyGsmSim800 : public TinyGsmModem<TinyGsmSim800>,
     sendAT(GF("+CBATCHK=1"));
     waitResponse();
 
+    // Keep the registration and PDP context state up to date from URCs
+    enableRegistrationReports(REG_REPORT_CREG);
+    enablePdpEvents();
+
     SimStatus ret = getSimStatus();
     // if the sim isn't ready and a pin has been provided, try to unlock the sim
     if (ret != SIM_READY && pin != nullptr && strlen(pin) > 0) {
@@ -248,7 +271,9 @@ class TinyGsmSim800 : public TinyGsmModem<TinyGsmSim800>,
     waitResponse();
     if (!setPhoneFunctionality(0)) { return false; }
     if (!setPhoneFunctionality(1, true)) { return false; }
-    delay(3000);
+    // RDY is only sent at a fixed baud rate; an auto-bauding module is found
+    // by the AT test in init() once this times out
+    waitResponse(3000L, GF("RDY"));
     return init(pin);
   }
 
@@ -406,6 +431,28 @@ class TinyGsmSim800 : public TinyGsmModem<TinyGsmSim800>,
     return res;
   }
 
+  /*
+   * DNS functions
+   */
+ protected:
+  bool dnsLookupImpl(const char* host, String& ip, uint32_t&) {
+    // The result comes after the OK as +CDNSGIP: 1,"<host>","<ip>"[,"<ip2>"]
+    // or +CDNSGIP: 0,<error>
+    sendAT(GF("+CDNSGIP=\""), host, '"');
+    if (waitResponse() != 1) { return false; }
+    if (waitResponse(30000L, GF("+CDNSGIP:")) != 1) { return false; }
+    if (streamGetIntBefore(',') != 1) {
+      streamSkipUntil('\n');
+      return false;
+    }
+    streamSkipUntil('"');  // Skip the host
+    streamSkipUntil('"');
+    streamSkipUntil('"');
+    ip = stream.readStringUntil('"');
+    streamSkipUntil('\n');
+    return true;
+  }
+
   /*
    * SIM card functions
    */
@@ -537,19 +584,21 @@ class TinyGsmSim800 : public TinyGsmModem<TinyGsmSim800>,
     if (waitResponse() != 1) return false;
 #endif
 #endif
-    sendAT(GF("+CIPSTART="), mux, ',', GF("\"TCP"), GF("\",\""), host,
+    String addr = hostToConnect(host, ssl);
+    sendAT(GF("+CIPSTART="), mux, ',', GF("\"TCP"), GF("\",\""), addr,
            GF("\","), port);
     rsp = waitResponse(
         timeout_ms, GF("CONNECT OK" AT_NL), GF("CONNECT FAIL" AT_NL),
         GF("ALREADY CONNECT" AT_NL), GF("ERROR" AT_NL),
         GF("CLOSE OK" AT_NL));  // Happens when HTTPS handshake fails
+    if (rsp != 1) { forgetHostIP(host); }
     return (1 == rsp);
   }
 
   int16_t modemSend(const void* buff, size_t len, uint8_t mux) {
     sendAT(GF("+CIPSEND="), mux, ',', (uint16_t)len);
     if (waitResponse(GF(">")) != 1) { return 0; }
-    stream.write(reinterpret_cast<const uint8_t*>(buff), len);
+    streamWriteSendData(buff, len);
     stream.flush();
     if (waitResponse(GF(AT_NL "DATA ACCEPT:")) != 1) { return 0; }
     streamSkipUntil(',');  // Skip mux
@@ -575,28 +624,19 @@ class TinyGsmSim800 : public TinyGsmModem<TinyGsmSim800>,
     // SRGD NOTE:  Contrary to above (which is copied from AT command manual)
     // this is actually be the number of bytes that will be remaining in the
     // buffer after the read.
-    for (int i = 0; i < len_requested; i++) {
-      uint32_t startMillis = millis();
 #ifdef TINY_GSM_USE_HEX
-      while (stream.available() < 2 &&
-             (millis() - startMillis < sockets[mux]->_timeout)) {
-        TINY_GSM_YIELD();
-      }
-      char buf[4] = {
-          0,
-      };
-      buf[0] = stream.read();
-      buf[1] = stream.read();
-      char c = strtol(buf, nullptr, 16);
+    moveHexFromStreamToFifo(mux, len_requested);
 #else
+    for (int i = 0; i < len_requested; i++) {
+      uint32_t startMillis = millis();
       while (!stream.available() &&
              (millis() - startMillis < sockets[mux]->_timeout)) {
         TINY_GSM_YIELD();
       }
       char c = stream.read();
-#endif
       sockets[mux]->rx.put(c);
     }
+#endif
     // DBG("### READ:", len_requested, "from", mux);
     // sockets[mux]->sock_available = modemGetAvailable(mux);
     sockets[mux]->sock_available = len_confirmed;
@@ -11,6 +11,7 @@
 // #pragma message("TinyGSM:  TinyGsmClientSaraR4")
 
 // #define TINY_GSM_DEBUG Serial
+// #define TINY_GSM_USE_DNS_CACHE
 
 #define TINY_GSM_MUX_COUNT 7
 #define TINY_GSM_BUFFER_READ_AND_CHECK_SIZE
@@ -37,6 +38,8 @@
 #include "TinyGsmGSMLocation.tpp"
 #include "TinyGsmGPS.tpp"
 #include "TinyGsmTime.tpp"
+#include "TinyGsmDNS.tpp"
+#include "TinyGsmPowerSave.tpp"
 #include "TinyGsmBattery.tpp"
 #include "TinyGsmTemperature.tpp"
 
@@ -59,7 +62,9 @@ class TinyGsmSaraR4 : public TinyGsmModem<TinyGsmSaraR4>,
                       public TinyGsmGPS<TinyGsmSaraR4>,
                       public TinyGsmTime<TinyGsmSaraR4>,
                       public TinyGsmBattery<TinyGsmSaraR4>,
-                      public TinyGsmTemperature<TinyGsmSaraR4> {
+                      public TinyGsmTemperature<TinyGsmSaraR4>,
+                      public TinyGsmDNS<TinyGsmSaraR4>,
+                      public TinyGsmPowerSave<TinyGsmSaraR4> {
   friend class TinyGsmModem<TinyGsmSaraR4>;
   friend class TinyGsmGPRS<TinyGsmSaraR4>;
   friend class TinyGsmTCP<TinyGsmSaraR4, TINY_GSM_MUX_COUNT>;
@@ -70,6 +75,16 @@ class TinyGsmSaraR4 : public TinyGsmModem<TinyGsmSaraR4>,
   friend class TinyGsmTime<TinyGsmSaraR4>;
   friend class TinyGsmTemperature<TinyGsmSaraR4>;
   friend class TinyGsmBattery<TinyGsmSaraR4>;
+  friend class TinyGsmDNS<TinyGsmSaraR4>;
+  friend class TinyGsmPowerSave<TinyGsmSaraR4>;
+
+  /*
+   * Socket command limits
+   */
+ public:
+  struct Traits : TinyGsmTcpTraits {
+    static constexpr size_t maxReadSize = 1024;
+  };
 
   /*
    * Inner Client
@@ -229,6 +244,9 @@ class TinyGsmSaraR4 : public TinyGsmModem<TinyGsmSaraR4>,
 
     if (!testAT()) { return false; }
 
+    // The SSL settings are sent again after a restart
+    ssl_config.clear();
+
     sendAT(GF("E0"));  // Echo Off
     if (waitResponse() != 1) { return false; }
 
@@ -257,6 +275,10 @@ class TinyGsmSaraR4 : public TinyGsmModem<TinyGsmSaraR4>,
     sendAT(GF("+CTZU=1"));
     if (waitResponse(10000L) != 1) { return false; }
 
+    // Keep the registration and PDP context state up to date from URCs
+    enableRegistrationReports(REG_REPORT_CEREG | REG_REPORT_CREG);
+    enablePdpEvents();
+
     SimStatus ret = getSimStatus();
     // if the sim isn't ready and a pin has been provided, try to unlock the sim
     if (ret != SIM_READY && pin != nullptr && strlen(pin) > 0) {
@@ -311,6 +333,15 @@ class TinyGsmSaraR4 : public TinyGsmModem<TinyGsmSaraR4>,
     return waitResponse(10000L) == 1;
   }
 
+  /*
+   * Power saving mode (PSM) functions
+   */
+ protected:
+  bool psmReportsImpl(bool enable) {
+    sendAT(GF("+UPSMR="), enable);  // +UUPSMR on entering and leaving PSM
+    return waitResponse() == 1;
+  }
+
   /*
    * Generic network functions
    */
@@ -409,6 +440,21 @@ class TinyGsmSaraR4 : public TinyGsmModem<TinyGsmSaraR4>,
     return true;
   }
 
+  /*
+   * DNS functions
+   */
+ protected:
+  bool dnsLookupImpl(const char* host, String& ip, uint32_t&) {
+    // AT+UDNSRN=<resolution_type>,<domain_ip_string>
+    // 0 is domain name to IP address
+    sendAT(GF("+UDNSRN=0,\""), host, '"');
+    if (waitResponse(70000L, GF("+UDNSRN:")) != 1) { return false; }
+    streamSkipUntil('"');
+    ip = stream.readStringUntil('"');
+    waitResponse();
+    return true;
+  }
+
   /*
    * SIM card functions
    */
@@ -678,6 +724,11 @@ class TinyGsmSaraR4 : public TinyGsmModem<TinyGsmSaraR4>,
     uint32_t timeout_ms  = ((uint32_t)timeout_s) * 1000;
     uint32_t startMillis = millis();
 
+    String addr = hostToConnect(host, ssl);
+
+    // The TLS profile is the client's; the socket number is the module's
+    if (ssl && !applyTLSProfile(*mux, host)) { return false; }
+
     // create a socket
     sendAT(GF("+USOCR=6"));
     // reply is +USOCR: ## of socket created
@@ -686,7 +737,8 @@ class TinyGsmSaraR4 : public TinyGsmModem<TinyGsmSaraR4>,
     waitResponse();
 
     if (ssl) {
-      sendAT(GF("+USOSEC="), *mux, ",1");
+      // AT+USOSEC=<socket>,<ssl_enabled>,<profile_id>
+      sendAT(GF("+USOSEC="), *mux, ",1,0");
       waitResponse();
     }
 
@@ -713,32 +765,85 @@ class TinyGsmSaraR4 : public TinyGsmModem<TinyGsmSaraR4>,
     if (supportsAsyncSockets) {
       DBG("### Opening socket asynchronously!  Socket cannot be used until "
           "the URC '+UUSOCO' appears.");
-      sendAT(GF("+USOCO="), *mux, ",\"", host, "\",", port, ",1");
+      sendAT(GF("+USOCO="), *mux, ",\"", addr, "\",", port, ",1");
       if (waitResponse(timeout_ms - (millis() - startMillis),
                        GF(AT_NL "+UUSOCO:")) == 1) {
         streamGetIntBefore(',');  // skip repeated mux
         int8_t connection_status = streamGetIntBefore('\n');
         DBG("### Waited", millis() - startMillis, "ms for socket to open");
+        if (connection_status != 0) { forgetHostIP(host); }
         return (0 == connection_status);
       } else {
         DBG("### Waited", millis() - startMillis,
             "but never got socket open notice");
+        forgetHostIP(host);
         return false;
       }
     } else {
       // use synchronous open
-      sendAT(GF("+USOCO="), *mux, ",\"", host, "\",", port);
+      sendAT(GF("+USOCO="), *mux, ",\"", addr, "\",", port);
       int8_t rsp = waitResponse(timeout_ms - (millis() - startMillis));
+      if (rsp != 1) { forgetHostIP(host); }
       return (1 == rsp);
     }
   }
 
+  // Sets security profile 0, which every secure socket uses, up from the
+  // socket's TLS profile as it connects.  The settings stay in the module, so
+  // only send those that changed.
+  // AT+USECPRF=<profile_id>,<op_code>,<param_val>[,<param_val2>,...]
+  bool applyTLSProfile(uint8_t mux, const char* host) {
+    const TinyGsmTLSProfile& profile = tls_profiles[mux];
+
+    // <op_code> 1: TLS version; 0: any, 1: TLS 1.0, 2: TLS 1.1, 3: TLS 1.2
+    uint8_t version = profile.versionOrAll();
+    if (version > TLS_VERSION_1_2) { version = 0; }  // all of them
+    char version_str[2] = {static_cast<char>('0' + version), '\0'};
+    if (ssl_config.needs(0, SSL_CFG_VERSION, version_str)) {
+      sendAT(GF("+USECPRF=0,1,"), version);
+      if (!sslConfigOk()) return false;
+    }
+
+    // <op_code> 2: cipher suite; 0: chosen by the module, 99: the suite's
+    // IANA number as two hex bytes, ie, 99,"C0","2F"
+    char suite[13] = "0";
+    if (profile.cipher_suite) {
+      static const char digits[] = "0123456789ABCDEF";
+      strcpy(suite, "99,\"00\",\"00\"");
+      for (uint8_t i = 0; i < 4; i++) {
+        suite[i < 2 ? 4 + i : 7 + i] =
+            digits[(profile.cipher_suite >> (12 - 4 * i)) & 0xF];
+      }
+    }
+    if (ssl_config.needs(0, SSL_CFG_CIPHERS, suite)) {
+      sendAT(GF("+USECPRF=0,2,"), suite);
+      if (!sslConfigOk()) return false;
+    }
+
+    // <op_code> 10: server name indication; an empty name turns it off
+    // NOTE:  older firmware doesn't have this, so an error is ignored
+    const char* sni = profile.sni ? host : "";
+    if (ssl_config.needs(0, SSL_CFG_SNI, sni)) {
+      sendAT(GF("+USECPRF=0,10,\""), sni, GF("\""));
+      waitResponse();
+    }
+    return true;
+  }
+
+  // Waits for the result of an SSL setting, forgetting the applied settings if
+  // it fails
+  bool sslConfigOk() {
+    if (waitResponse() == 1) { return true; }
+    ssl_config.clear();
+    return false;
+  }
+
   int16_t modemSend(const void* buff, size_t len, uint8_t mux) {
     sendAT(GF("+USOWR="), mux, ',', (uint16_t)len);
     if (waitResponse(GF("@")) != 1) { return 0; }
     // 50ms delay, see AT manual section 25.10.4
     delay(50);
-    stream.write(reinterpret_cast<const uint8_t*>(buff), len);
+    streamWriteSendData(buff, len);
     stream.flush();
     if (waitResponse(GF(AT_NL "+USOWR:")) != 1) { return 0; }
     streamSkipUntil(',');  // Skip mux
@@ -747,6 +852,10 @@ class TinyGsmSaraR4 : public TinyGsmModem<TinyGsmSaraR4>,
     return sent;
   }
 
+  int16_t modemSendLast(const void* buff, size_t len, uint8_t mux) {
+    return modemSendThenCNMPSD(buff, len, mux);
+  }
+
   size_t modemRead(size_t size, uint8_t mux) {
     if (!sockets[mux]) return 0;
     sendAT(GF("+USORD="), mux, ',', (uint16_t)size);
@@ -841,6 +950,13 @@ class TinyGsmSaraR4 : public TinyGsmModem<TinyGsmSaraR4>,
       data = "";
       DBG("### URC Sock Opened: ", mux);
       return true;
+    } else if (data.endsWith(GF("+UUPSMR:"))) {
+      // +UUPSMR: <state>[,<param1>]; 1 is in PSM
+      int8_t state = streamGetIntBefore('\n');
+      psm_state    = state == 1 ? 1 : 0;
+      data         = "";
+      DBG("### PSM:", state);
+      return true;
     }
     return false;
   }
@@ -849,9 +965,10 @@ class TinyGsmSaraR4 : public TinyGsmModem<TinyGsmSaraR4>,
   Stream& stream;
 
  protected:
-  GsmClientSaraR4* sockets[TINY_GSM_MUX_COUNT];
-  bool             has2GFallback;
-  bool             supportsAsyncSockets;
+  GsmClientSaraR4*         sockets[TINY_GSM_MUX_COUNT];
+  TinyGsmSSLConfigCache<1> ssl_config;  // all sockets use profile 0
+  bool                     has2GFallback;
+  bool                     supportsAsyncSockets;
 };
 
 #endif  // SRC_TINYGSMCLIENTSARAR4_H_
@@ -11,6 +11,7 @@
 // #pragma message("TinyGSM:  TinyGsmClientSaraR5")
 
 // #define TINY_GSM_DEBUG Serial
+// #define TINY_GSM_USE_DNS_CACHE
 
 #define TINY_GSM_MUX_COUNT 7
 #define TINY_GSM_BUFFER_READ_AND_CHECK_SIZE
@@ -38,6 +39,8 @@
 #include "TinyGsmGSMLocation.tpp"
 #include "TinyGsmGPS.tpp"
 #include "TinyGsmTime.tpp"
+#include "TinyGsmDNS.tpp"
+#include "TinyGsmPowerSave.tpp"
 #include "TinyGsmBattery.tpp"
 
 enum SaraR5RegStatus {
@@ -74,7 +77,9 @@ class TinyGsmSaraR5 : public TinyGsmModem<TinyGsmSaraR5>,
                       public TinyGsmGSMLocation<TinyGsmSaraR5>,
                       public TinyGsmGPS<TinyGsmSaraR5>,
                       public TinyGsmTime<TinyGsmSaraR5>,
-                      public TinyGsmBattery<TinyGsmSaraR5> {
+                      public TinyGsmBattery<TinyGsmSaraR5>,
+                      public TinyGsmDNS<TinyGsmSaraR5>,
+                      public TinyGsmPowerSave<TinyGsmSaraR5> {
   friend class TinyGsmModem<TinyGsmSaraR5>;
   friend class TinyGsmGPRS<TinyGsmSaraR5>;
   friend class TinyGsmTCP<TinyGsmSaraR5, TINY_GSM_MUX_COUNT>;
@@ -85,6 +90,16 @@ class TinyGsmSaraR5 : public TinyGsmModem<TinyGsmSaraR5>,
   friend class TinyGsmGPS<TinyGsmSaraR5>;
   friend class TinyGsmTime<TinyGsmSaraR5>;
   friend class TinyGsmBattery<TinyGsmSaraR5>;
+  friend class TinyGsmDNS<TinyGsmSaraR5>;
+  friend class TinyGsmPowerSave<TinyGsmSaraR5>;
+
+  /*
+   * Socket command limits
+   */
+ public:
+  struct Traits : TinyGsmTcpTraits {
+    static constexpr size_t maxReadSize = 1024;
+  };
 
   /*
    * Inner Client
@@ -200,6 +215,9 @@ class TinyGsmSaraR5 : public TinyGsmModem<TinyGsmSaraR5>,
 
     if (!testAT()) { return false; }
 
+    // The SSL settings are sent again after a restart
+    ssl_config.clear();
+
     sendAT(GF("E0"));  // Echo Off
     if (waitResponse() != 1) { return false; }
 
@@ -218,6 +236,10 @@ class TinyGsmSaraR5 : public TinyGsmModem<TinyGsmSaraR5>,
     // Ignore the response, in case the network doesn't support it.
     // if (waitResponse(10000L) != 1) { return false; }
 
+    // Keep the registration and PDP context state up to date from URCs
+    enableRegistrationReports(REG_REPORT_CEREG | REG_REPORT_CREG);
+    enablePdpEvents();
+
     SimStatus ret = getSimStatus();
     // if the sim isn't ready and a pin has been provided, try to unlock the sim
     if (ret != SIM_READY && pin != nullptr && strlen(pin) > 0) {
@@ -273,6 +295,15 @@ class TinyGsmSaraR5 : public TinyGsmModem<TinyGsmSaraR5>,
     return waitResponse(10000L) == 1;
   }
 
+  /*
+   * Power saving mode (PSM) functions
+   */
+ protected:
+  bool psmReportsImpl(bool enable) {
+    sendAT(GF("+UPSMR="), enable);  // +UUPSMR on entering and leaving PSM
+    return waitResponse() == 1;
+  }
+
   /*
    * Generic network functions
    */
@@ -439,6 +470,47 @@ class TinyGsmSaraR5 : public TinyGsmModem<TinyGsmSaraR5>,
     return true;
   }
 
+  /*
+   * Fast attach functions
+   */
+ protected:
+  // Puts the access technology that served last first, when the module is set
+  // to use both LTE-M (7) and NB-IoT (8)
+  bool setAttachProfileImpl(const TinyGsmAttachProfile& profile,
+                            uint32_t                    timeout_ms) {
+    sendAT(GF("+URAT?"));
+    String line;
+    if (waitResponse(GF("+URAT:")) == 1) {
+      line = stream.readStringUntil('\n');
+      waitResponse();
+    }
+    int8_t first = profile.act == 9 ? 8 : 7;
+    if ((profile.act == 7 || profile.act == 9) && line.indexOf('7') >= 0 &&
+        line.indexOf('8') >= 0 && line.toInt() != first) {
+      sendAT(GF("+COPS=2"));  // URAT can only be changed while deregistered
+      waitResponse(10000L);
+      sendAT(GF("+URAT="), first, ',', first == 7 ? 8 : 7);
+      waitResponse();
+    }
+    return TinyGsmGPRS<TinyGsmSaraR5>::setAttachProfileImpl(profile,
+                                                            timeout_ms);
+  }
+
+  /*
+   * DNS functions
+   */
+ protected:
+  bool dnsLookupImpl(const char* host, String& ip, uint32_t&) {
+    // AT+UDNSRN=<resolution_type>,<domain_ip_string>
+    // 0 is domain name to IP address
+    sendAT(GF("+UDNSRN=0,\""), host, '"');
+    if (waitResponse(70000L, GF("+UDNSRN:")) != 1) { return false; }
+    streamSkipUntil('"');
+    ip = stream.readStringUntil('"');
+    waitResponse();
+    return true;
+  }
+
   /*
    * SIM card functions
    */
@@ -661,6 +733,11 @@ class TinyGsmSaraR5 : public TinyGsmModem<TinyGsmSaraR5>,
     uint32_t timeout_ms  = ((uint32_t)timeout_s) * 1000;
     uint32_t startMillis = millis();
 
+    String addr = hostToConnect(host, ssl);
+
+    // The TLS profile is the client's; the socket number is the module's
+    if (ssl && !applyTLSProfile(*mux, host)) { return false; }
+
     // create a socket
     sendAT(GF("+USOCR=6"));
     // reply is +USOCR: ## of socket created
@@ -669,7 +746,8 @@ class TinyGsmSaraR5 : public TinyGsmModem<TinyGsmSaraR5>,
     waitResponse();
 
     if (ssl) {
-      sendAT(GF("+USOSEC="), *mux, ",1");
+      // AT+USOSEC=<socket>,<ssl_enabled>,<profile_id>
+      sendAT(GF("+USOSEC="), *mux, ",1,0");
       waitResponse();
     }
 
@@ -686,17 +764,75 @@ class TinyGsmSaraR5 : public TinyGsmModem<TinyGsmSaraR5>,
     // waitResponse();
 
     // connect on the allocated socket
-    sendAT(GF("+USOCO="), *mux, ",\"", host, "\",", port);
+    sendAT(GF("+USOCO="), *mux, ",\"", addr, "\",", port);
     int8_t rsp = waitResponse(timeout_ms - (millis() - startMillis));
+    if (rsp != 1) { forgetHostIP(host); }
     return (1 == rsp);
   }
 
-  int16_t modemSend(const void* buff, size_t len, uint8_t mux) {
-    sendAT(GF("+USOWR="), mux, ',', (uint16_t)len);
+  // Sets security profile 0, which every secure socket uses, up from the
+  // socket's TLS profile as it connects.  The settings stay in the module, so
+  // only send those that changed.
+  // AT+USECPRF=<profile_id>,<op_code>,<param_val>[,<param_val2>,...]
+  bool applyTLSProfile(uint8_t mux, const char* host) {
+    const TinyGsmTLSProfile& profile = tls_profiles[mux];
+
+    // <op_code> 1: TLS version; 0: any, 1: TLS 1.0, 2: TLS 1.1, 3: TLS 1.2
+    uint8_t version = profile.versionOrAll();
+    if (version > TLS_VERSION_1_2) { version = 0; }  // all of them
+    char version_str[2] = {static_cast<char>('0' + version), '\0'};
+    if (ssl_config.needs(0, SSL_CFG_VERSION, version_str)) {
+      sendAT(GF("+USECPRF=0,1,"), version);
+      if (!sslConfigOk()) return false;
+    }
+
+    // <op_code> 2: cipher suite; 0: chosen by the module, 99: the suite's
+    // IANA number as two hex bytes, ie, 99,"C0","2F"
+    char suite[13] = "0";
+    if (profile.cipher_suite) {
+      static const char digits[] = "0123456789ABCDEF";
+      strcpy(suite, "99,\"00\",\"00\"");
+      for (uint8_t i = 0; i < 4; i++) {
+        suite[i < 2 ? 4 + i : 7 + i] =
+            digits[(profile.cipher_suite >> (12 - 4 * i)) & 0xF];
+      }
+    }
+    if (ssl_config.needs(0, SSL_CFG_CIPHERS, suite)) {
+      sendAT(GF("+USECPRF=0,2,"), suite);
+      if (!sslConfigOk()) return false;
+    }
+
+    // <op_code> 10: server name indication; an empty name turns it off
+    // NOTE:  older firmware doesn't have this, so an error is ignored
+    const char* sni = profile.sni ? host : "";
+    if (ssl_config.needs(0, SSL_CFG_SNI, sni)) {
+      sendAT(GF("+USECPRF=0,10,\""), sni, GF("\""));
+      waitResponse();
+    }
+    return true;
+  }
+
+  // Waits for the result of an SSL setting, forgetting the applied settings if
+  // it fails
+  bool sslConfigOk() {
+    if (waitResponse() == 1) { return true; }
+    ssl_config.clear();
+    return false;
+  }
+
+  // rai is the release assistance indication given with the write: 1 when
+  // no more data is expected
+  int16_t modemSend(const void* buff, size_t len, uint8_t mux,
+                    uint8_t rai = 0) {
+    if (rai) {
+      sendAT(GF("+USOWR="), mux, ',', (uint16_t)len, ',', rai);
+    } else {
+      sendAT(GF("+USOWR="), mux, ',', (uint16_t)len);
+    }
     if (waitResponse(GF("@")) != 1) { return 0; }
     // 50ms delay, see AT manual section 25.10.4
     delay(50);
-    stream.write(reinterpret_cast<const uint8_t*>(buff), len);
+    streamWriteSendData(buff, len);
     stream.flush();
     if (waitResponse(GF(AT_NL "+USOWR:")) != 1) { return 0; }
     streamSkipUntil(',');  // Skip mux
@@ -705,6 +841,10 @@ class TinyGsmSaraR5 : public TinyGsmModem<TinyGsmSaraR5>,
     return sent;
   }
 
+  int16_t modemSendLast(const void* buff, size_t len, uint8_t mux) {
+    return modemSend(buff, len, mux, 1);
+  }
+
   size_t modemRead(size_t size, uint8_t mux) {
     if (!sockets[mux]) return 0;
     sendAT(GF("+USORD="), mux, ',', (uint16_t)size);
@@ -789,6 +929,13 @@ class TinyGsmSaraR5 : public TinyGsmModem<TinyGsmSaraR5>,
       data = "";
       DBG("### URC Sock Closed: ", mux);
       return true;
+    } else if (data.endsWith(GF("+UUPSMR:"))) {
+      // +UUPSMR: <state>[,<param1>]; 1 is in PSM
+      int8_t state = streamGetIntBefore('\n');
+      psm_state    = state == 1 ? 1 : 0;
+      data         = "";
+      DBG("### PSM:", state);
+      return true;
     }
     return false;
   }
@@ -817,7 +964,8 @@ class TinyGsmSaraR5 : public TinyGsmModem<TinyGsmSaraR5>,
   Stream& stream;
 
  protected:
-  GsmClientSaraR5* sockets[TINY_GSM_MUX_COUNT];
+  GsmClientSaraR5*         sockets[TINY_GSM_MUX_COUNT];
+  TinyGsmSSLConfigCache<1> ssl_config;  // all sockets use profile 0
 };
 
 #endif  // SRC_TINYGSMCLIENTSARAR5_H_
@@ -231,6 +231,10 @@ class TinyGsmSequansMonarch
     sendAT(GF("+CTZU=1"));
     if (waitResponse(10000L) != 1) { return false; }
 
+    // Keep the registration and PDP context state up to date from URCs
+    enableRegistrationReports(REG_REPORT_CEREG);
+    enablePdpEvents();
+
     SimStatus ret = getSimStatus();
     // if the sim isn't ready and a pin has been provided, try to unlock the sim
     if (ret != SIM_READY && pin != nullptr && strlen(pin) > 0) {
@@ -302,8 +306,10 @@ class TinyGsmSequansMonarch
     return waitResponse() == 1;
   }
 
-  bool setPhoneFunctionalityImpl(uint8_t fun, bool reset = false)
-      TINY_GSM_ATTR_NOT_IMPLEMENTED;
+  bool setPhoneFunctionalityImpl(uint8_t fun, bool reset = false) {
+    sendAT(GF("+CFUN="), fun, reset ? ",1" : "");
+    return waitResponse(10000L) == 1;
+  }
 
   /*
    * Generic network functions
@@ -546,12 +552,18 @@ class TinyGsmSequansMonarch
     sendAT(GF("+SQNSSENDEXT="), mux, ',', (uint16_t)len);
     waitResponse(10000L, GF(AT_NL "> "));
     // Translate bytes into char to be able to send them as an hex string
-    char char_command[3];
-    for (size_t i = 0; i < len; i++) {
-      memset(&char_command, 0, sizeof(char_command));
-      sprintf(&char_command[0], "%02X",
-              reinterpret_cast<const uint8_t*>(buff)[i]);
-      stream.write(char_command, sizeof(char_command));
+    char    char_command[3];
+    uint8_t chunk[16];
+    for (size_t i = 0; i < len;) {
+      size_t n = readSendData(buff, i, chunk,
+                              TinyGsmMin(len - i, sizeof(chunk)));
+      if (n == 0) break;
+      for (size_t j = 0; j < n; j++) {
+        memset(&char_command, 0, sizeof(char_command));
+        sprintf(&char_command[0], "%02X", chunk[j]);
+        stream.write(char_command, sizeof(char_command));
+      }
+      i += n;
     }
     stream.flush();
     if (waitResponse() != 1) {
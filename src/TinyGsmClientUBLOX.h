@@ -11,6 +11,8 @@
 // #pragma message("TinyGSM:  TinyGsmClientUBLOX")
 
 // #define TINY_GSM_DEBUG Serial
+// #define TINY_GSM_USE_HEX
+// #define TINY_GSM_USE_DNS_CACHE
 
 #define TINY_GSM_MUX_COUNT 7
 #define TINY_GSM_BUFFER_READ_AND_CHECK_SIZE
@@ -38,6 +40,7 @@
 #include "TinyGsmGSMLocation.tpp"
 #include "TinyGsmGPS.tpp"
 #include "TinyGsmTime.tpp"
+#include "TinyGsmDNS.tpp"
 #include "TinyGsmBattery.tpp"
 
 enum UBLOXRegStatus {
@@ -59,7 +62,8 @@ class TinyGsmUBLOX : public TinyGsmModem<TinyGsmUBLOX>,
                      public TinyGsmGSMLocation<TinyGsmUBLOX>,
                      public TinyGsmGPS<TinyGsmUBLOX>,
                      public TinyGsmTime<TinyGsmUBLOX>,
-                     public TinyGsmBattery<TinyGsmUBLOX> {
+                     public TinyGsmBattery<TinyGsmUBLOX>,
+                     public TinyGsmDNS<TinyGsmUBLOX> {
   friend class TinyGsmModem<TinyGsmUBLOX>;
   friend class TinyGsmGPRS<TinyGsmUBLOX>;
   friend class TinyGsmTCP<TinyGsmUBLOX, TINY_GSM_MUX_COUNT>;
@@ -70,6 +74,19 @@ class TinyGsmUBLOX : public TinyGsmModem<TinyGsmUBLOX>,
   friend class TinyGsmGPS<TinyGsmUBLOX>;
   friend class TinyGsmTime<TinyGsmUBLOX>;
   friend class TinyGsmBattery<TinyGsmUBLOX>;
+  friend class TinyGsmDNS<TinyGsmUBLOX>;
+
+  /*
+   * Socket command limits
+   */
+ public:
+  struct Traits : TinyGsmTcpTraits {
+#ifdef TINY_GSM_USE_HEX
+    static constexpr size_t maxReadSize = 512;  // two characters a byte
+#else
+    static constexpr size_t maxReadSize = 1024;
+#endif
+  };
 
   /*
    * Inner Client
@@ -184,6 +201,9 @@ class TinyGsmUBLOX : public TinyGsmModem<TinyGsmUBLOX>,
 
     if (!testAT()) { return false; }
 
+    // The SSL settings are sent again after a restart
+    ssl_config.clear();
+
     sendAT(GF("E0"));  // Echo Off
     if (waitResponse() != 1) { return false; }
 
@@ -196,12 +216,22 @@ class TinyGsmUBLOX : public TinyGsmModem<TinyGsmUBLOX>,
 
     DBG(GF("### Modem:"), getModemName());
 
+#ifdef TINY_GSM_USE_HEX
+    // Exchange socket data as hex strings
+    sendAT(GF("+UDCONF=1,1"));
+    if (waitResponse() != 1) { return false; }
+#endif
+
     // Enable automatic time zome update
     sendAT(GF("+CTZU=1"));
     waitResponse(10000L);
     // Ignore the response, in case the network doesn't support it.
     // if (waitResponse(10000L) != 1) { return false; }
 
+    // Keep the registration and PDP context state up to date from URCs
+    enableRegistrationReports(REG_REPORT_CGREG);
+    enablePdpEvents();
+
     SimStatus ret = getSimStatus();
     // if the sim isn't ready and a pin has been provided, try to unlock the sim
     if (ret != SIM_READY && pin != nullptr && strlen(pin) > 0) {
@@ -403,6 +433,21 @@ class TinyGsmUBLOX : public TinyGsmModem<TinyGsmUBLOX>,
     return true;
   }
 
+  /*
+   * DNS functions
+   */
+ protected:
+  bool dnsLookupImpl(const char* host, String& ip, uint32_t&) {
+    // AT+UDNSRN=<resolution_type>,<domain_ip_string>
+    // 0 is domain name to IP address
+    sendAT(GF("+UDNSRN=0,\""), host, '"');
+    if (waitResponse(70000L, GF("+UDNSRN:")) != 1) { return false; }
+    streamSkipUntil('"');
+    ip = stream.readStringUntil('"');
+    waitResponse();
+    return true;
+  }
+
   /*
    * SIM card functions
    */
@@ -648,6 +693,11 @@ class TinyGsmUBLOX : public TinyGsmModem<TinyGsmUBLOX>,
     uint32_t timeout_ms  = ((uint32_t)timeout_s) * 1000;
     uint32_t startMillis = millis();
 
+    String addr = hostToConnect(host, ssl);
+
+    // The TLS profile is the client's; the socket number is the module's
+    if (ssl && !applyTLSProfile(*mux, host)) { return false; }
+
     // create a socket
     sendAT(GF("+USOCR=6"));
     // reply is +USOCR: ## of socket created
@@ -656,7 +706,8 @@ class TinyGsmUBLOX : public TinyGsmModem<TinyGsmUBLOX>,
     waitResponse();
 
     if (ssl) {
-      sendAT(GF("+USOSEC="), *mux, ",1");
+      // AT+USOSEC=<socket>,<ssl_enabled>,<profile_id>
+      sendAT(GF("+USOSEC="), *mux, ",1,0");
       waitResponse();
     }
 
@@ -673,18 +724,77 @@ class TinyGsmUBLOX : public TinyGsmModem<TinyGsmUBLOX>,
     // waitResponse();
 
     // connect on the allocated socket
-    sendAT(GF("+USOCO="), *mux, ",\"", host, "\",", port);
+    sendAT(GF("+USOCO="), *mux, ",\"", addr, "\",", port);
     int8_t rsp = waitResponse(timeout_ms - (millis() - startMillis));
+    if (rsp != 1) { forgetHostIP(host); }
     return (1 == rsp);
   }
 
+  // Sets security profile 0, which every secure socket uses, up from the
+  // socket's TLS profile as it connects.  The settings stay in the module, so
+  // only send those that changed.
+  // AT+USECPRF=<profile_id>,<op_code>,<param_val>[,<param_val2>,...]
+  bool applyTLSProfile(uint8_t mux, const char* host) {
+    const TinyGsmTLSProfile& profile = tls_profiles[mux];
+
+    // <op_code> 1: TLS version; 0: any, 1: TLS 1.0, 2: TLS 1.1, 3: TLS 1.2
+    uint8_t version = profile.versionOrAll();
+    if (version > TLS_VERSION_1_2) { version = 0; }  // all of them
+    char version_str[2] = {static_cast<char>('0' + version), '\0'};
+    if (ssl_config.needs(0, SSL_CFG_VERSION, version_str)) {
+      sendAT(GF("+USECPRF=0,1,"), version);
+      if (!sslConfigOk()) return false;
+    }
+
+    // <op_code> 2: cipher suite; 0: chosen by the module, 99: the suite's
+    // IANA number as two hex bytes, ie, 99,"C0","2F"
+    char suite[13] = "0";
+    if (profile.cipher_suite) {
+      static const char digits[] = "0123456789ABCDEF";
+      strcpy(suite, "99,\"00\",\"00\"");
+      for (uint8_t i = 0; i < 4; i++) {
+        suite[i < 2 ? 4 + i : 7 + i] =
+            digits[(profile.cipher_suite >> (12 - 4 * i)) & 0xF];
+      }
+    }
+    if (ssl_config.needs(0, SSL_CFG_CIPHERS, suite)) {
+      sendAT(GF("+USECPRF=0,2,"), suite);
+      if (!sslConfigOk()) return false;
+    }
+
+    // <op_code> 10: server name indication; an empty name turns it off
+    // NOTE:  older firmware doesn't have this, so an error is ignored
+    const char* sni = profile.sni ? host : "";
+    if (ssl_config.needs(0, SSL_CFG_SNI, sni)) {
+      sendAT(GF("+USECPRF=0,10,\""), sni, GF("\""));
+      waitResponse();
+    }
+    return true;
+  }
+
+  // Waits for the result of an SSL setting, forgetting the applied settings if
+  // it fails
+  bool sslConfigOk() {
+    if (waitResponse() == 1) { return true; }
+    ssl_config.clear();
+    return false;
+  }
+
   int16_t modemSend(const void* buff, size_t len, uint8_t mux) {
+#ifdef TINY_GSM_USE_HEX
+    // In hex mode the data is sent inline, two hex characters per byte
+    streamWrite(GF("AT+USOWR="), mux, ',', (uint16_t)len, GF(",\""));
+    streamWriteSendDataHex(buff, len);
+    streamWrite('"', AT_NL);
+    stream.flush();
+#else
     sendAT(GF("+USOWR="), mux, ',', (uint16_t)len);
     if (waitResponse(GF("@")) != 1) { return 0; }
     // 50ms delay, see AT manual section 25.10.4
     delay(50);
-    stream.write(reinterpret_cast<const uint8_t*>(buff), len);
+    streamWriteSendData(buff, len);
     stream.flush();
+#endif
     if (waitResponse(GF(AT_NL "+USOWR:")) != 1) { return 0; }
     streamSkipUntil(',');  // Skip mux
     int16_t sent = streamGetIntBefore('\n');
@@ -700,7 +810,12 @@ class TinyGsmUBLOX : public TinyGsmModem<TinyGsmUBLOX>,
     int16_t len = streamGetIntBefore(',');
     streamSkipUntil('\"');
 
+#ifdef TINY_GSM_USE_HEX
+    // The length is in bytes; each byte arrives as two hex characters
+    moveHexFromStreamToFifo(mux, len);
+#else
     for (int i = 0; i < len; i++) { moveCharFromStreamToFifo(mux); }
+#endif
     streamSkipUntil('\"');
     waitResponse();
     // DBG("### READ:", len, "from", mux);
@@ -784,7 +899,8 @@ class TinyGsmUBLOX : public TinyGsmModem<TinyGsmUBLOX>,
   Stream& stream;
 
  protected:
-  GsmClientUBLOX* sockets[TINY_GSM_MUX_COUNT];
+  GsmClientUBLOX*          sockets[TINY_GSM_MUX_COUNT];
+  TinyGsmSSLConfigCache<1> ssl_config;  // all sockets use profile 0
 };
 
 #endif  // SRC_TINYGSMCLIENTUBLOX_H_
@@ -179,6 +179,8 @@ class TinyGsmXBee : public TinyGsmModem<TinyGsmXBee>,
       return write((const uint8_t*)str, strlen(str));
     }
 
+    using GsmClient::write;
+
     int available() override {
       TINY_GSM_YIELD();
       return at->stream.available();
@@ -652,8 +654,19 @@ class TinyGsmXBee : public TinyGsmModem<TinyGsmXBee>,
 
   bool sleepEnableImpl(bool enable = true) TINY_GSM_ATTR_NOT_IMPLEMENTED;
 
-  bool setPhoneFunctionalityImpl(uint8_t fun, bool reset = false)
-      TINY_GSM_ATTR_NOT_IMPLEMENTED;
+  // Anything less than full functionality is airplane mode; use restart() for
+  // a reset.  The change is applied but not written to flash, so the XBee
+  // comes back up in the mode it was saved with.
+  bool setPhoneFunctionalityImpl(uint8_t fun, bool = false) {
+    bool success = true;
+    XBEE_COMMAND_START_DECORATOR(5, false)
+    if (changeSettingIfNeeded(GF("AM"), fun == 1 ? 0x0 : 0x1, 5000L)) {
+      sendAT(GF("AC"));  // Apply changes
+      success = waitResponse() == 1;
+    }
+    XBEE_COMMAND_END_DECORATOR
+    return success;
+  }
 
   /*
    * Generic network functions
@@ -964,6 +977,12 @@ class TinyGsmXBee : public TinyGsmModem<TinyGsmXBee>,
     return sendATGetString(GF("MN"));
   }
 
+  bool getAttachProfileImpl(TinyGsmAttachProfile& profile)
+      TINY_GSM_ATTR_NOT_IMPLEMENTED;
+  bool setAttachProfileImpl(const TinyGsmAttachProfile& profile,
+                            uint32_t timeout_ms) TINY_GSM_ATTR_NOT_IMPLEMENTED;
+  bool clearAttachProfileImpl() TINY_GSM_ATTR_NOT_IMPLEMENTED;
+
   /*
    * SIM card functions
    */
@@ -1312,7 +1331,7 @@ class TinyGsmXBee : public TinyGsmModem<TinyGsmXBee>,
     if (mux != 0) {
       DBG("XBee only supports 1 IP channel in transparent mode!");
     }
-    stream.write(reinterpret_cast<const uint8_t*>(buff), len);
+    streamWriteSendData(buff, len);
     stream.flush();
 
     if (beeType != XBEE_S6B_WIFI) {
@@ -1329,6 +1348,11 @@ class TinyGsmXBee : public TinyGsmModem<TinyGsmXBee>,
     return len;
   }
 
+  // Sends are transparent, so there is no command to follow them with
+  int16_t modemSendLast(const void* buff, size_t len, uint8_t mux) {
+    return modemSend(buff, len, mux);
+  }
+
   // NOTE:  The CI command returns the status of the TCP connection as open only
   // after data has been sent on the socket.  If it returns 0xFF the socket may
   // really be open, but no data has yet been sent.  We return this unknown
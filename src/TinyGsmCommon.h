@@ -43,11 +43,15 @@
 
 #if defined(__AVR__) && !defined(__AVR_ATmega4809__)
 #define TINY_GSM_PROGMEM PROGMEM
+#define TINY_GSM_PGM_READ_BYTE(x) pgm_read_byte(x)
+#define TINY_GSM_PGM_READ_DWORD(x) pgm_read_dword(x)
 typedef const __FlashStringHelper* GsmConstStr;
 #define GFP(x) (reinterpret_cast<GsmConstStr>(x))
 #define GF(x) F(x)
 #else
 #define TINY_GSM_PROGMEM
+#define TINY_GSM_PGM_READ_BYTE(x) (*(x))
+#define TINY_GSM_PGM_READ_DWORD(x) (*(x))
 typedef const char* GsmConstStr;
 #define GFP(x) x
 #define GF(x) x
@@ -110,6 +114,55 @@ const T& TinyGsmMax(const T& a, const T& b) {
   return (b < a) ? a : b;
 }
 
+/*
+ * Hex Decoding Helpers
+ */
+// The value of each ASCII character as a hex digit; anything that isn't a hex
+// digit decodes as 0
+static const uint8_t TinyGsmHexNibble[256] TINY_GSM_PROGMEM = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 0, 0, 0, 0, 0, 0,
+    0, 10, 11, 12, 13, 14, 15, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 10, 11, 12, 13, 14, 15, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+};
+
+inline uint8_t TinyGsmHexToByte(char hi, char lo) {
+  return (TINY_GSM_PGM_READ_BYTE(&TinyGsmHexNibble[(uint8_t)hi]) << 4) |
+      TINY_GSM_PGM_READ_BYTE(&TinyGsmHexNibble[(uint8_t)lo]);
+}
+
+// Decodes len bytes from the 2 * len hex characters in 'in'.  Decoding in
+// place (out == in) is allowed.
+inline void TinyGsmHexToBytes(const char* in, uint8_t* out, size_t len) {
+#if !defined(__AVR__) && defined(__BYTE_ORDER__) && \
+    __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  // If the input is word aligned, take four characters (two bytes) per load
+  if ((reinterpret_cast<uintptr_t>(in) & 3) == 0) {
+    for (; len >= 2; len -= 2, in += 4, out += 2) {
+      uint32_t w;
+      memcpy(&w, in, 4);
+      out[0] = (TinyGsmHexNibble[w & 0xFF] << 4) |
+          TinyGsmHexNibble[(w >> 8) & 0xFF];
+      out[1] = (TinyGsmHexNibble[(w >> 16) & 0xFF] << 4) |
+          TinyGsmHexNibble[w >> 24];
+    }
+  }
+#endif
+  for (; len; len--, in += 2) { *out++ = TinyGsmHexToByte(in[0], in[1]); }
+}
+
 /*
  * Automatically find baud rate
  */
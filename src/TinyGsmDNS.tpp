@@ -0,0 +1,152 @@
+/**
+ * @file       TinyGsmDNS.tpp
+ * @author     Volodymyr Shymanskyy
+ * @license    LGPL-3.0
+ * @copyright  Copyright (c) 2016 Volodymyr Shymanskyy
+ * @date       Oct 2026
+ */
+
+#ifndef SRC_TINYGSMDNS_H_
+#define SRC_TINYGSMDNS_H_
+
+#include "TinyGsmCommon.h"
+
+#define TINY_GSM_MODEM_HAS_DNS
+
+// Number of host names to keep the address of
+#ifndef TINY_GSM_DNS_CACHE_SIZE
+#define TINY_GSM_DNS_CACHE_SIZE 4
+#endif
+
+// How long to keep an address for, when the module doesn't give a TTL
+#ifndef TINY_GSM_DNS_CACHE_TTL
+#define TINY_GSM_DNS_CACHE_TTL 300000L
+#endif
+
+template <class modemType>
+class TinyGsmDNS {
+  /* =========================================== */
+  /* =========================================== */
+  /*
+   * Define the interface
+   */
+ public:
+  /*
+   * DNS functions
+   */
+  // Returns the IP address of the host as a string, from the cache if it has
+  // been looked up recently.  Returns an empty string if the lookup fails.
+  String getHostIP(const char* host) {
+    if (*host == '\0' || isIPAddress(host)) { return host; }
+
+    // Find the host in the cache, or else the slot to put it in: an empty one
+    // or the one looked up longest ago
+    DNSCacheEntry* slot   = &dns_cache[0];
+    uint32_t       oldest = 0;
+    for (uint8_t i = 0; i < TINY_GSM_DNS_CACHE_SIZE; i++) {
+      DNSCacheEntry& e = dns_cache[i];
+      if (e.host == host) {
+        if (millis() - e.stored < e.ttl_ms) { return e.ip; }
+        slot = &e;
+        break;
+      }
+      uint32_t age = e.host.length() ? millis() - e.stored : 0xFFFFFFFF;
+      if (age >= oldest) {
+        oldest = age;
+        slot   = &e;
+      }
+    }
+
+    String   ip;
+    uint32_t ttl_ms = TINY_GSM_DNS_CACHE_TTL;
+    if (!thisModem().dnsLookupImpl(host, ip, ttl_ms) || !ip.length()) {
+      DBG("### DNS lookup failed for", host);
+      return "";
+    }
+    DBG("### DNS:", host, "->", ip);
+    slot->host   = host;
+    slot->ip     = ip;
+    slot->stored = millis();
+    slot->ttl_ms = ttl_ms;
+    return ip;
+  }
+  String getHostIP(const String& host) {
+    return getHostIP(host.c_str());
+  }
+
+  void clearDNSCache() {
+    for (uint8_t i = 0; i < TINY_GSM_DNS_CACHE_SIZE; i++) {
+      dns_cache[i].host = "";
+      dns_cache[i].ip   = "";
+    }
+  }
+
+  /*
+   * CRTP Helper
+   */
+ protected:
+  inline const modemType& thisModem() const {
+    return static_cast<const modemType&>(*this);
+  }
+  inline modemType& thisModem() {
+    return static_cast<modemType&>(*this);
+  }
+  ~TinyGsmDNS() {}
+
+  /* =========================================== */
+  /* =========================================== */
+  /*
+   * Define the default function implementations
+   */
+
+  /*
+   * DNS functions
+   */
+ protected:
+  // Looks up the first address of the host.  May lower ttl_ms to the TTL the
+  // module reports.
+  bool dnsLookupImpl(const char* host, String& ip,
+                     uint32_t& ttl_ms) TINY_GSM_ATTR_NOT_IMPLEMENTED;
+
+  // The host to hand to the module's open command.  With TINY_GSM_USE_DNS_CACHE
+  // this is the cached address, so the module doesn't look the host up again
+  // on every connect.  SSL connections keep the host name, which the module
+  // needs for the server name indication and the certificate check.
+  String hostToConnect(const char* host, bool ssl = false) {
+    if (ssl) { return host; }
+#ifdef TINY_GSM_USE_DNS_CACHE
+    String ip = getHostIP(host);
+    if (ip.length()) { return ip; }
+#endif
+    return host;
+  }
+
+  // Drops the cached address of a host after a failed open, in case it was
+  // the address that was at fault
+  void forgetHostIP(const char* host) {
+    for (uint8_t i = 0; i < TINY_GSM_DNS_CACHE_SIZE; i++) {
+      if (dns_cache[i].host == host) {
+        dns_cache[i].host = "";
+        dns_cache[i].ip   = "";
+      }
+    }
+  }
+
+  static bool isIPAddress(const char* host) {
+    if (*host == '\0') { return false; }
+    for (; *host; host++) {
+      if (!isDigit(*host) && *host != '.') { return false; }
+    }
+    return true;
+  }
+
+  struct DNSCacheEntry {
+    String   host;
+    String   ip;
+    uint32_t stored;
+    uint32_t ttl_ms;
+  };
+  DNSCacheEntry dns_cache[TINY_GSM_DNS_CACHE_SIZE];
+};
+
+#endif  // SRC_TINYGSMDNS_H_
@@ -1,17 +1,63 @@
 #ifndef TinyGsmFifo_h
 #define TinyGsmFifo_h
 
-template <class T, unsigned N>
+// The signed type used for the FIFO positions and counts.  It must be able to
+// hold the size of the largest buffer; AVR boards keep a 16-bit type, while
+// elsewhere 32 bits allow buffers of 64k and more (ie, in external PSRAM).
+#ifndef TINY_GSM_FIFO_INDEX_TYPE
+#if defined(__AVR__)
+#define TINY_GSM_FIFO_INDEX_TYPE int16_t
+#else
+#define TINY_GSM_FIFO_INDEX_TYPE int32_t
+#endif
+#endif
+
+// N may be 0 for a FIFO that only ever uses an external buffer; it then holds
+// nothing until setBuffer() is called.
+template <class T, unsigned long N, class I = TINY_GSM_FIFO_INDEX_TYPE>
 class TinyGsmFifo {
  public:
+  /// The number of items beyond what the index type can count
+  static const unsigned long max_size = 1UL << (sizeof(I) * 8 - 1);
+
+  static_assert(N < max_size, "FIFO size is too large for the index type");
+
   /**
    * @brief Construct a new Tiny Gsm Fifo object, setting the head and tail to
    * 0.
    */
-  TinyGsmFifo() {
+  TinyGsmFifo() : _b(_storage), _n(N ? N : 1) {
     clear();
   }
 
+  /**
+   * @brief Store the items in an externally provided buffer instead of the
+   * built-in one, ie, in external RAM.  This clears the FIFO.
+   *
+   * @param buf The buffer to use; nullptr to go back to the built-in buffer
+   * @param n The number of items the buffer can hold.  As with the built-in
+   * buffer, one position is always left empty.
+   */
+  void setBuffer(T* buf, I n) {
+    if (buf != nullptr && n > 1) {
+      _b = buf;
+      _n = n;
+    } else {
+      _b = _storage;
+      _n = N ? N : 1;
+    }
+    clear();
+  }
+
+  /**
+   * @brief Get the number of items the FIFO can hold when it's full
+   *
+   * @return *I* The usable size of the buffer
+   */
+  I capacity(void) {
+    return _n - 1;
+  }
+
   /**
    * @brief Clear the FIFO - set the read and write positions to 0
    */
@@ -36,11 +82,11 @@ class TinyGsmFifo {
   /**
    * @brief Check the number of free positions in the buffer.
    *
-   * @return *int*  The number number of free positions in the buffer
+   * @return *I*  The number number of free positions in the buffer
    */
-  int free(void) {
-    int s = _r - _w;     // Check if the read is ahead of the write
-    if (s <= 0) s += N;  // if not wrap
+  I free(void) {
+    I s = _r - _w;     // Check if the read is ahead of the write
+    if (s <= 0) s += _n;  // if not wrap
     return s - 1;  // return the difference between r and w, accounting for wrap
   }
 
@@ -52,8 +98,8 @@ class TinyGsmFifo {
    * @return *false* Nothing was added to the buffer
    */
   bool put(const T& c) {
-    int i = _w;       // check the write position
-    int j = i;        // set the spot for the new item to the write position
+    I i = _w;         // check the write position
+    I j = i;          // set the spot for the new item to the write position
     i     = _inc(i);  // check where the next increment of the write will be
     if (i == _r)  // make sure the next spot isn't the position of the read (ie,
                   // the buffer is full)
@@ -70,12 +116,12 @@ class TinyGsmFifo {
    * @param n The number of items to add
    * @param t Whether to block while waiting for space enough space to clear to
    * add all items
-   * @return *int* The number of items successfully added
+   * @return *I* The number of items successfully added
    */
-  int put(const T* p, int n, bool t = false) {
-    int c = n;
+  I put(const T* p, I n, bool t = false) {
+    I c = n;
     while (c) {
-      int f;
+      I f;
       while ((f = free()) == 0)  // wait for space
       {
         if (!t) return n - c;  // no more space and not blocking
@@ -83,8 +129,8 @@ class TinyGsmFifo {
       }
       // check free space
       if (c < f) f = c;
-      int w = _w;
-      int m = N - w;
+      I w = _w;
+      I m = _n - w;
       // check wrap
       if (f > m) f = m;
       memcpy(&_b[w], p, f);
@@ -103,13 +149,13 @@ class TinyGsmFifo {
   }
 
   size_t size(void) {
-    int s = _w - _r;
-    if (s < 0) s += N;
+    I s = _w - _r;
+    if (s < 0) s += _n;
     return s;
   }
 
   bool get(T* p) {
-    int r = _r;
+    I r = _r;
     if (r == _w)  // !readable()
       return false;
     *p = _b[r];
@@ -117,10 +163,10 @@ class TinyGsmFifo {
     return true;
   }
 
-  int get(T* p, int n, bool t = false) {
-    int c = n;
+  I get(T* p, I n, bool t = false) {
+    I c = n;
     while (c) {
-      int f;
+      I f;
       for (;;)  // wait for data
       {
         f = size();
@@ -130,8 +176,8 @@ class TinyGsmFifo {
       }
       // check available data
       if (c < f) f = c;
-      int r = _r;
-      int m = N - r;
+      I r = _r;
+      I m = _n - r;
       // check wrap
       if (f > m) f = m;
       memcpy(p, &_b[r], f);
@@ -153,15 +199,19 @@ class TinyGsmFifo {
    *
    * @param i
    * @param n
-   * @return *int*
+   * @return *I*
    */
-  int _inc(int i, int n = 1) {
-    return (i + n) % N;
+  I _inc(I i, I n = 1) {
+    i += n;
+    if (i >= _n) i -= _n;
+    return i;
   }
 
-  T   _b[N];  /// The buffer, containing 'N' items of type 'T'
-  int _w;     /// The write position in the buffer
-  int _r;     /// The read position in the buffer
+  T  _storage[N ? N : 1];  /// The built-in buffer of 'N' items of type 'T'
+  T* _b;                   /// The buffer in use - built-in or external
+  I  _n;                   /// The number of items the buffer in use can contain
+  I  _w;                   /// The write position in the buffer
+  I  _r;                   /// The read position in the buffer
 };
 
 #endif
@@ -20,6 +20,14 @@ enum SimStatus {
   SIM_ANTITHEFT_LOCKED = 3,
 };
 
+// The network a module was last served by, kept by the sketch between boots
+// so that fastAttach() can go back to it without a full scan
+struct TinyGsmAttachProfile {
+  char     plmn[7];  // MCC and MNC, ie: "26201"; empty if there is none yet
+  int8_t   act;      // Access technology as the module gives it in +COPS
+  uint16_t band;     // Serving band, 0 if the module doesn't report it
+};
+
 template <class modemType>
 class TinyGsmGPRS {
   /* =========================================== */
@@ -56,14 +64,24 @@ class TinyGsmGPRS {
    */
   bool gprsConnect(const char* apn, const char* user = nullptr,
                    const char* pwd = nullptr) {
-    return thisModem().gprsConnectImpl(apn, user, pwd);
+    bool ok = thisModem().gprsConnectImpl(apn, user, pwd);
+    if (thisModem().pdp_events) { thisModem().pdpChanged(ok ? 1 : -1); }
+    return ok;
   }
   bool gprsDisconnect() {
-    return thisModem().gprsDisconnectImpl();
+    bool ok = thisModem().gprsDisconnectImpl();
+    if (thisModem().pdp_events) { thisModem().pdpChanged(ok ? 0 : -1); }
+    return ok;
   }
-  // Checks if current attached to GPRS/EPS service
+  // Checks if current attached to GPRS/EPS service.  With PDP context events
+  // on, the module is only asked when an event has left the state unknown.
   bool isGprsConnected() {
-    return thisModem().isGprsConnectedImpl();
+    if (!thisModem().pdp_events) { return thisModem().isGprsConnectedImpl(); }
+    thisModem().streamClear();  // Picks up any waiting events
+    if (thisModem().pdp_state < 0) {
+      thisModem().pdpChanged(thisModem().isGprsConnectedImpl() ? 1 : 0);
+    }
+    return thisModem().pdp_state == 1;
   }
   // Gets the current network operator
   String getOperator() {
@@ -75,6 +93,41 @@ class TinyGsmGPRS {
     return thisModem().getProviderImpl();
   }
 
+  /*
+   * Fast attach functions
+   */
+  // Gets the network, access technology and band the module is served by
+  bool getAttachProfile(TinyGsmAttachProfile& profile) {
+    return thisModem().getAttachProfileImpl(profile);
+  }
+
+  // Waits for the network, trying the network and access technology of the
+  // profile for up to deadline_ms before falling back to a full scan for the
+  // rest of timeout_ms.  Once registered the profile is updated to the
+  // serving network, for the sketch to store if it changed.
+  bool fastAttach(TinyGsmAttachProfile& profile,
+                  uint32_t deadline_ms = 30000L,
+                  uint32_t timeout_ms  = 180000L) {
+    uint32_t start = millis();
+    bool     ok    = false;
+    if (profile.plmn[0] != '\0') {
+      bool     selected = thisModem().setAttachProfileImpl(profile,
+                                                            deadline_ms);
+      uint32_t elapsed  = millis() - start;
+      ok = selected && elapsed < deadline_ms &&
+          thisModem().waitForNetwork(deadline_ms - elapsed);
+      if (!ok) {
+        DBG("### No network on", profile.plmn, "- scanning");
+        thisModem().clearAttachProfileImpl();
+      }
+    }
+    if (!ok && millis() - start < timeout_ms) {
+      ok = thisModem().waitForNetwork(timeout_ms - (millis() - start));
+    }
+    if (ok) { getAttachProfile(profile); }
+    return ok;
+  }
+
   /*
    * CRTP Helper
    */
@@ -142,7 +195,8 @@ class TinyGsmGPRS {
     for (uint32_t start = millis(); millis() - start < timeout_ms;) {
       thisModem().sendAT(GF("+CPIN?"));
       if (thisModem().waitResponse(GF("+CPIN:")) != 1) {
-        delay(1000);
+        // Ask again as soon as the SIM says it's ready
+        thisModem().waitResponse(1000L, GF("+CPIN: READY"));
         continue;
       }
       int8_t status =
@@ -185,6 +239,62 @@ class TinyGsmGPRS {
   }
 
   String getProviderImpl() TINY_GSM_ATTR_NOT_IMPLEMENTED;
+
+  /*
+   * Fast attach functions
+   */
+ protected:
+  // Reads the serving network in numeric format via the 3GPP TS command
+  // AT+COPS, then puts the format back to operator names
+  bool getAttachProfileImpl(TinyGsmAttachProfile& profile) {
+    thisModem().sendAT(GF("+COPS=3,2"));
+    if (thisModem().waitResponse() != 1) { return false; }
+    thisModem().sendAT(GF("+COPS?"));
+    String line;
+    if (thisModem().waitResponse(GF("+COPS:")) == 1) {
+      line = thisModem().stream.readStringUntil('\n');
+      thisModem().waitResponse();
+    }
+    thisModem().sendAT(GF("+COPS=3,0"));
+    thisModem().waitResponse();
+
+    // <mode>[,<format>,<oper>[,<AcT>]]
+    int start = line.indexOf('"');
+    int end   = line.indexOf('"', start + 1);
+    if (start < 0 || end < 0 || end - start > (int)sizeof(profile.plmn)) {
+      return false;
+    }
+    line.substring(start + 1, end).toCharArray(profile.plmn,
+                                               sizeof(profile.plmn));
+    int comma    = line.indexOf(',', end);
+    profile.act  = comma < 0 ? -1 : line.substring(comma + 1).toInt();
+    profile.band = thisModem().getServingBandImpl();
+    return true;
+  }
+
+  uint16_t getServingBandImpl() {
+    return 0;
+  }
+
+  // Selects the network with AT+COPS mode 4, manual with the module falling
+  // back to automatic selection if it can't be found.  Modules that answer
+  // once registered are given up to timeout_ms.
+  bool setAttachProfileImpl(const TinyGsmAttachProfile& profile,
+                            uint32_t                    timeout_ms) {
+    if (profile.act >= 0) {
+      thisModem().sendAT(GF("+COPS=4,2,\""), profile.plmn, GF("\","),
+                         profile.act);
+    } else {
+      thisModem().sendAT(GF("+COPS=4,2,\""), profile.plmn, '"');
+    }
+    return thisModem().waitResponse(timeout_ms) == 1;
+  }
+
+  // Goes back to automatic network selection
+  bool clearAttachProfileImpl() {
+    thisModem().sendAT(GF("+COPS=0"));
+    return thisModem().waitResponse() == 1;
+  }
 };
 
 #endif  // SRC_TINYGSMGPRS_H_
@@ -0,0 +1,438 @@
+/**
+ * @file       TinyGsmHttpDownload.h
+ * @author     Volodymyr Shymanskyy
+ * @license    LGPL-3.0
+ * @copyright  Copyright (c) 2016 Volodymyr Shymanskyy
+ * @date       Oct 2026
+ */
+
+#ifndef SRC_TINYGSMHTTPDOWNLOAD_H_
+#define SRC_TINYGSMHTTPDOWNLOAD_H_
+
+#include "TinyGsmCommon.h"
+
+// Size of the buffer each read from a socket goes through
+#ifndef TINY_GSM_DOWNLOAD_CHUNK
+#define TINY_GSM_DOWNLOAD_CHUNK 256
+#endif
+
+/*
+ * Where a download is written.  Segments of the resource arrive in whatever
+ * order the sockets deliver them, so each write gives the offset its data
+ * belongs at.  Return false to abort the download.
+ */
+class TinyGsmDownloadSink {
+ public:
+  virtual bool write(uint32_t offset, const uint8_t* data, size_t len) = 0;
+
+ protected:
+  ~TinyGsmDownloadSink() {}
+};
+
+// Pass as the last byte of a range to ask for everything from the first on
+#define TINY_GSM_RANGE_TO_END 0xFFFFFFFFUL
+
+// Sends a GET for bytes first to last (inclusive) of the resource.  The
+// request goes out as a single send.
+static inline size_t TinyGsmHttpGetRange(
+    Client& client, const char* host, const char* path, uint32_t first,
+    uint32_t last = TINY_GSM_RANGE_TO_END) {
+  String req;
+  req.reserve(64 + strlen(host) + strlen(path));
+  req += "GET ";
+  req += path;
+  req += " HTTP/1.1\r\nHost: ";
+  req += host;
+  req += "\r\nRange: bytes=";
+  req += first;
+  req += '-';
+  if (last != TINY_GSM_RANGE_TO_END) { req += last; }
+  req += "\r\nConnection: close\r\n\r\n";
+  return client.write(reinterpret_cast<const uint8_t*>(req.c_str()),
+                      req.length());
+}
+
+// Reads the status line and headers of a response, waiting up to timeout_ms
+// for it to start.  Returns the status code, or 0 if no response came.
+// length is the Content-Length, and total the size of the whole resource,
+// taken from Content-Range (or from Content-Length for a plain 200).
+static inline int TinyGsmHttpReadHeaders(Client& client, uint32_t& length,
+                                         uint32_t& total,
+                                         uint32_t timeout_ms = 30000L) {
+  length = 0;
+  total  = 0;
+  for (uint32_t start = millis(); !client.available();) {
+    if (!client.connected() || millis() - start > timeout_ms) { return 0; }
+    delay(10);
+  }
+
+  String line = client.readStringUntil('\n');
+  if (!line.startsWith("HTTP/")) { return 0; }
+  int status = line.substring(line.indexOf(' ') + 1).toInt();
+
+  while (client.connected() || client.available()) {
+    line = client.readStringUntil('\n');
+    line.trim();
+    if (line.length() == 0) { break; }  // end of the headers
+    line.toLowerCase();
+    if (line.startsWith("content-length:")) {
+      length = line.substring(15).toInt();
+    } else if (line.startsWith("content-range:")) {
+      int slash = line.indexOf('/');
+      if (slash > 0) { total = line.substring(slash + 1).toInt(); }
+    }
+  }
+  if (status == 200) { total = length; }
+  return status;
+}
+
+/*
+ * Table driven CRC-32 (the one used by zip, zlib and Ethernet), for checking a
+ * download as it arrives.  A CRC saved part way through can be carried on
+ * with by passing it to the constructor.
+ */
+static const uint32_t TinyGsmCRC32Table[256] TINY_GSM_PROGMEM = {
+    0x00000000, 0x77073096, 0xEE0E612C, 0x990951BA, 0x076DC419, 0x706AF48F,
+    0xE963A535, 0x9E6495A3, 0x0EDB8832, 0x79DCB8A4, 0xE0D5E91E, 0x97D2D988,
+    0x09B64C2B, 0x7EB17CBD, 0xE7B82D07, 0x90BF1D91, 0x1DB71064, 0x6AB020F2,
+    0xF3B97148, 0x84BE41DE, 0x1ADAD47D, 0x6DDDE4EB, 0xF4D4B551, 0x83D385C7,
+    0x136C9856, 0x646BA8C0, 0xFD62F97A, 0x8A65C9EC, 0x14015C4F, 0x63066CD9,
+    0xFA0F3D63, 0x8D080DF5, 0x3B6E20C8, 0x4C69105E, 0xD56041E4, 0xA2677172,
+    0x3C03E4D1, 0x4B04D447, 0xD20D85FD, 0xA50AB56B, 0x35B5A8FA, 0x42B2986C,
+    0xDBBBC9D6, 0xACBCF940, 0x32D86CE3, 0x45DF5C75, 0xDCD60DCF, 0xABD13D59,
+    0x26D930AC, 0x51DE003A, 0xC8D75180, 0xBFD06116, 0x21B4F4B5, 0x56B3C423,
+    0xCFBA9599, 0xB8BDA50F, 0x2802B89E, 0x5F058808, 0xC60CD9B2, 0xB10BE924,
+    0x2F6F7C87, 0x58684C11, 0xC1611DAB, 0xB6662D3D, 0x76DC4190, 0x01DB7106,
+    0x98D220BC, 0xEFD5102A, 0x71B18589, 0x06B6B51F, 0x9FBFE4A5, 0xE8B8D433,
+    0x7807C9A2, 0x0F00F934, 0x9609A88E, 0xE10E9818, 0x7F6A0DBB, 0x086D3D2D,
+    0x91646C97, 0xE6635C01, 0x6B6B51F4, 0x1C6C6162, 0x856530D8, 0xF262004E,
+    0x6C0695ED, 0x1B01A57B, 0x8208F4C1, 0xF50FC457, 0x65B0D9C6, 0x12B7E950,
+    0x8BBEB8EA, 0xFCB9887C, 0x62DD1DDF, 0x15DA2D49, 0x8CD37CF3, 0xFBD44C65,
+    0x4DB26158, 0x3AB551CE, 0xA3BC0074, 0xD4BB30E2, 0x4ADFA541, 0x3DD895D7,
+    0xA4D1C46D, 0xD3D6F4FB, 0x4369E96A, 0x346ED9FC, 0xAD678846, 0xDA60B8D0,
+    0x44042D73, 0x33031DE5, 0xAA0A4C5F, 0xDD0D7CC9, 0x5005713C, 0x270241AA,
+    0xBE0B1010, 0xC90C2086, 0x5768B525, 0x206F85B3, 0xB966D409, 0xCE61E49F,
+    0x5EDEF90E, 0x29D9C998, 0xB0D09822, 0xC7D7A8B4, 0x59B33D17, 0x2EB40D81,
+    0xB7BD5C3B, 0xC0BA6CAD, 0xEDB88320, 0x9ABFB3B6, 0x03B6E20C, 0x74B1D29A,
+    0xEAD54739, 0x9DD277AF, 0x04DB2615, 0x73DC1683, 0xE3630B12, 0x94643B84,
+    0x0D6D6A3E, 0x7A6A5AA8, 0xE40ECF0B, 0x9309FF9D, 0x0A00AE27, 0x7D079EB1,
+    0xF00F9344, 0x8708A3D2, 0x1E01F268, 0x6906C2FE, 0xF762575D, 0x806567CB,
+    0x196C3671, 0x6E6B06E7, 0xFED41B76, 0x89D32BE0, 0x10DA7A5A, 0x67DD4ACC,
+    0xF9B9DF6F, 0x8EBEEFF9, 0x17B7BE43, 0x60B08ED5, 0xD6D6A3E8, 0xA1D1937E,
+    0x38D8C2C4, 0x4FDFF252, 0xD1BB67F1, 0xA6BC5767, 0x3FB506DD, 0x48B2364B,
+    0xD80D2BDA, 0xAF0A1B4C, 0x36034AF6, 0x41047A60, 0xDF60EFC3, 0xA867DF55,
+    0x316E8EEF, 0x4669BE79, 0xCB61B38C, 0xBC66831A, 0x256FD2A0, 0x5268E236,
+    0xCC0C7795, 0xBB0B4703, 0x220216B9, 0x5505262F, 0xC5BA3BBE, 0xB2BD0B28,
+    0x2BB45A92, 0x5CB36A04, 0xC2D7FFA7, 0xB5D0CF31, 0x2CD99E8B, 0x5BDEAE1D,
+    0x9B64C2B0, 0xEC63F226, 0x756AA39C, 0x026D930A, 0x9C0906A9, 0xEB0E363F,
+    0x72076785, 0x05005713, 0x95BF4A82, 0xE2B87A14, 0x7BB12BAE, 0x0CB61B38,
+    0x92D28E9B, 0xE5D5BE0D, 0x7CDCEFB7, 0x0BDBDF21, 0x86D3D2D4, 0xF1D4E242,
+    0x68DDB3F8, 0x1FDA836E, 0x81BE16CD, 0xF6B9265B, 0x6FB077E1, 0x18B74777,
+    0x88085AE6, 0xFF0F6A70, 0x66063BCA, 0x11010B5C, 0x8F659EFF, 0xF862AE69,
+    0x616BFFD3, 0x166CCF45, 0xA00AE278, 0xD70DD2EE, 0x4E048354, 0x3903B3C2,
+    0xA7672661, 0xD06016F7, 0x4969474D, 0x3E6E77DB, 0xAED16A4A, 0xD9D65ADC,
+    0x40DF0B66, 0x37D83BF0, 0xA9BCAE53, 0xDEBB9EC5, 0x47B2CF7F, 0x30B5FFE9,
+    0xBDBDF21C, 0xCABAC28A, 0x53B39330, 0x24B4A3A6, 0xBAD03605, 0xCDD70693,
+    0x54DE5729, 0x23D967BF, 0xB3667A2E, 0xC4614AB8, 0x5D681B02, 0x2A6F2B94,
+    0xB40BBE37, 0xC30C8EA1, 0x5A05DF1B, 0x2D02EF8D,
+};
+
+class TinyGsmCRC32 {
+ public:
+  explicit TinyGsmCRC32(uint32_t crc = 0) : state(~crc) {}
+
+  void update(const uint8_t* data, size_t len) {
+    uint32_t c = state;
+    while (len--) {
+      c = TINY_GSM_PGM_READ_DWORD(&TinyGsmCRC32Table[(c ^ *data++) & 0xFF]) ^
+          (c >> 8);
+    }
+    state = c;
+  }
+
+  uint32_t value() const {
+    return ~state;
+  }
+
+ protected:
+  uint32_t state;
+};
+
+/*
+ * Downloads a resource over several connections at once, each fetching one
+ * `Range:` segment of it.  The sockets are read in turn, so the modem has data
+ * for all of them arriving while each is being read out.
+ *
+ *   TinyGsmClient client0(modem, 0);
+ *   TinyGsmClient client1(modem, 1);
+ *   TinyGsmRangeDownload<TinyGsmClient, 2> download;
+ *   download.add(client0);
+ *   download.add(client1);
+ *
+ *   int32_t size = download.get(server, 80, "/firmware.bin", sink);
+ *
+ * The size is learned from a first request for one byte.  If the server
+ * doesn't support ranges the whole resource comes over the first client.
+ */
+template <class clientType, uint8_t maxSegments>
+class TinyGsmRangeDownload {
+ public:
+  TinyGsmRangeDownload() : count(0) {}
+
+  // Add a client (and so its mux) to fetch a segment with
+  bool add(clientType& client) {
+    if (count >= maxSegments) { return false; }
+    segments[count].client = &client;
+    count++;
+    return true;
+  }
+
+  // Downloads path from the host into the sink.  Returns the size of the
+  // resource, or -1 if the download failed.  timeout_ms is how long to wait
+  // with no data arriving on any socket.
+  int32_t get(const char* host, uint16_t port, const char* path,
+              TinyGsmDownloadSink& sink, uint32_t timeout_ms = 30000L) {
+    if (count == 0) { return -1; }
+
+    // Ask for the first byte to learn the size and whether ranges work
+    Segment& first = segments[0];
+    if (!first.client->connect(host, port)) { return -1; }
+    TinyGsmHttpGetRange(*first.client, host, path, 0, 0);
+    uint32_t length;
+    uint32_t total;
+    int status = TinyGsmHttpReadHeaders(*first.client, length, total,
+                                        timeout_ms);
+    if (status == 200 && total > 0) {
+      // No range support, read the whole thing on the one connection
+      DBG("### Download: no range support, using one connection");
+      first.offset = 0;
+      first.end    = total;
+      return finish(1, pump(sink, 1, timeout_ms) ? total : -1);
+    }
+    first.client->stop();
+    if (status != 206 || total == 0) {
+      DBG("### Download: HTTP status", status);
+      return -1;
+    }
+
+    // Split the resource and request every segment before reading any
+    uint8_t  used = 0;
+    uint32_t per  = (total + count - 1) / count;
+    for (uint8_t i = 0; i < count; i++) {
+      Segment& s = segments[i];
+      s.offset   = static_cast<uint32_t>(i) * per;
+      if (s.offset >= total) { break; }
+      s.end = s.offset + per < total ? s.offset + per : total;
+      used++;
+      if (!s.client->connect(host, port)) { return finish(used, -1); }
+      TinyGsmHttpGetRange(*s.client, host, path, s.offset, s.end - 1);
+    }
+    for (uint8_t i = 0; i < used; i++) {
+      Segment& s = segments[i];
+      if (TinyGsmHttpReadHeaders(*s.client, length, total, timeout_ms) !=
+              206 ||
+          length != s.end - s.offset) {
+        DBG("### Download: bad response for segment", i);
+        return finish(used, -1);
+      }
+    }
+    DBG("### Download:", total, "bytes in", used, "segments");
+    return finish(used, pump(sink, used, timeout_ms) ? total : -1);
+  }
+
+ protected:
+  struct Segment {
+    clientType* client;
+    uint32_t    offset;  // next byte to read
+    uint32_t    end;     // one past the last byte
+  };
+
+  // Reads a chunk from each unfinished segment in turn until all are done
+  bool pump(TinyGsmDownloadSink& sink, uint8_t used, uint32_t timeout_ms) {
+    uint8_t  buf[TINY_GSM_DOWNLOAD_CHUNK];
+    uint32_t last_data = millis();
+    bool     busy      = true;
+    while (busy) {
+      busy = false;
+      for (uint8_t i = 0; i < used; i++) {
+        Segment& s = segments[i];
+        if (s.offset >= s.end) { continue; }
+        busy        = true;
+        size_t want = s.end - s.offset < sizeof(buf) ? s.end - s.offset
+                                                     : sizeof(buf);
+        int got = s.client->read(buf, want);
+        if (got <= 0) { continue; }
+        if (!sink.write(s.offset, buf, got)) { return false; }
+        s.offset += got;
+        last_data = millis();
+      }
+      if (busy && millis() - last_data > timeout_ms) {
+        DBG("### Download: timed out");
+        return false;
+      }
+    }
+    return true;
+  }
+
+  int32_t finish(uint8_t used, int32_t result) {
+    for (uint8_t i = 0; i < used; i++) { segments[i].client->stop(); }
+    return result;
+  }
+
+  Segment segments[maxSegments];
+  uint8_t count;
+};
+
+/*
+ * Downloads a resource over one connection, checking it with a CRC-32 as it
+ * arrives.  When the connection drops, the download is picked up where it
+ * stopped with a `Range:` request, after a back off that doubles with each
+ * attempt.
+ *
+ *   TinyGsmResumableDownload<TinyGsmClient> ota(client);
+ *   ota.resume(saved_offset, saved_crc);  // progress saved by an earlier run
+ *   if (ota.get(server, 80, "/firmware.bin", sink) &&
+ *       ota.crc32() == known_crc) {
+ *     // ... apply the update ...
+ *   }
+ *
+ * To survive a reset, save received() and crc32() somewhere persistent after
+ * the sink has stored the data (or after get() gives up) and pass them to
+ * resume() next time.
+ *
+ * The end of the resource comes from the Content-Range size, or else from the
+ * Content-Length.  Only when the server gives neither is the download taken
+ * as finished when the connection closes; a connection dropped early then
+ * can't be told from the end, so check crc32() against a known value.
+ */
+template <class clientType>
+class TinyGsmResumableDownload {
+ public:
+  explicit TinyGsmResumableDownload(clientType& client)
+      : client(client),
+        offset(0),
+        total(0),
+        crc(),
+        max_retries(5),
+        backoff_ms(1000),
+        max_backoff_ms(60000L) {}
+
+  // Carry on from an earlier download of the same resource
+  void resume(uint32_t received, uint32_t crc32) {
+    offset = received;
+    crc    = TinyGsmCRC32(crc32);
+  }
+
+  // How many times to reconnect after the connection drops, and how long to
+  // wait before the first retry
+  void setRetries(uint8_t retries, uint32_t first_backoff_ms = 1000,
+                  uint32_t longest_backoff_ms = 60000L) {
+    max_retries    = retries;
+    backoff_ms     = first_backoff_ms;
+    max_backoff_ms = longest_backoff_ms;
+  }
+
+  // Downloads the rest of path from the host into the sink.  Returns true once
+  // the whole resource has been received.  timeout_ms is how long to wait with
+  // no data arriving before treating the connection as dropped.
+  bool get(const char* host, uint16_t port, const char* path,
+           TinyGsmDownloadSink& sink, uint32_t timeout_ms = 30000L) {
+    uint32_t wait = backoff_ms;
+    for (uint8_t attempt = 0;; attempt++) {
+      FetchResult result = fetch(host, port, path, sink, timeout_ms);
+      if (result == FETCH_DONE) { return true; }
+      if (result == FETCH_FAILED || attempt >= max_retries) { return false; }
+      DBG("### Download: retrying from", offset, "in", wait, "ms");
+      delay(wait);
+      wait = wait * 2 < max_backoff_ms ? wait * 2 : max_backoff_ms;
+    }
+  }
+
+  // Bytes received so far, and the CRC-32 of them
+  uint32_t received() const {
+    return offset;
+  }
+  uint32_t crc32() const {
+    return crc.value();
+  }
+  // Size of the whole resource, once the server has said
+  uint32_t size() const {
+    return total;
+  }
+
+ protected:
+  enum FetchResult {
+    FETCH_DONE   = 0,
+    FETCH_RETRY  = 1,
+    FETCH_FAILED = 2,
+  };
+
+  FetchResult fetch(const char* host, uint16_t port, const char* path,
+                    TinyGsmDownloadSink& sink, uint32_t timeout_ms) {
+    if (total > 0 && offset >= total) { return FETCH_DONE; }
+    if (!client.connect(host, port)) { return FETCH_RETRY; }
+    TinyGsmHttpGetRange(client, host, path, offset);
+
+    uint32_t length;
+    int      status = TinyGsmHttpReadHeaders(client, length, total, timeout_ms);
+    if (status == 200 && offset > 0) {
+      // The server ignored the range, so start again from the beginning
+      DBG("### Download: no range support, restarting");
+      offset = 0;
+      crc    = TinyGsmCRC32();
+    } else if (status == 416) {
+      // Asked for bytes past the end; already have everything
+      client.stop();
+      return offset > 0 ? FETCH_DONE : FETCH_FAILED;
+    } else if (status != 200 && status != 206) {
+      DBG("### Download: HTTP status", status);
+      client.stop();
+      return status == 0 || status >= 500 ? FETCH_RETRY : FETCH_FAILED;
+    }
+    // Without a size in the Content-Range (bytes a-b/*), the open ended range
+    // ends where its Content-Length does
+    if (total == 0 && length > 0) { total = offset + length; }
+
+    uint8_t  buf[TINY_GSM_DOWNLOAD_CHUNK];
+    uint32_t last_data = millis();
+    bool     closed    = false;
+    while (total == 0 || offset < total) {
+      size_t want = sizeof(buf);
+      if (total > 0 && total - offset < want) { want = total - offset; }
+      int got = client.read(buf, want);
+      if (got > 0) {
+        if (!sink.write(offset, buf, got)) {
+          client.stop();
+          return FETCH_FAILED;
+        }
+        crc.update(buf, got);
+        offset += got;
+        last_data = millis();
+      } else if (!client.connected()) {
+        closed = true;
+        break;
+      } else if (millis() - last_data > timeout_ms) {
+        break;
+      }
+    }
+    client.stop();
+
+    // With no length at all, the server closing the connection is the only
+    // end there is
+    if (total == 0 && closed && offset > 0) {
+      total = offset;
+      return FETCH_DONE;
+    }
+    return total > 0 && offset >= total ? FETCH_DONE : FETCH_RETRY;
+  }
+
+  clientType&  client;
+  uint32_t     offset;
+  uint32_t     total;
+  TinyGsmCRC32 crc;
+  uint8_t      max_retries;
+  uint32_t     backoff_ms;
+  uint32_t     max_backoff_ms;
+};
+
+#endif  // SRC_TINYGSMHTTPDOWNLOAD_H_
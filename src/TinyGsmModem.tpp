@@ -41,6 +41,12 @@
 #define MODEM_MODEL "unknown"
 #endif
 
+// How long the registration state kept from the modem's reports is trusted
+// without a new report, in milliseconds
+#ifndef TINY_GSM_REG_CHECK_INTERVAL
+#define TINY_GSM_REG_CHECK_INTERVAL 60000L
+#endif
+
 static const char GSM_OK[] TINY_GSM_PROGMEM    = AT_OK AT_NL;
 static const char GSM_ERROR[] TINY_GSM_PROGMEM = AT_ERROR AT_NL;
 
@@ -49,6 +55,21 @@ static const char GSM_VERBOSE[] TINY_GSM_PROGMEM   = AT_VERBOSE;
 static const char GSM_VERBOSE_2[] TINY_GSM_PROGMEM = AT_VERBOSE_2;
 #endif
 
+// The registration reports a module can keep the modem object up to date with
+enum RegistrationReport : uint8_t {
+  REG_REPORT_CREG  = 0x01,  // Circuit switched (GSM)
+  REG_REPORT_CGREG = 0x02,  // Packet switched (GPRS/UMTS)
+  REG_REPORT_CEREG = 0x04,  // EPS (LTE)
+};
+
+// The last registration state reported by the module
+struct TinyGsmRegistration {
+  int8_t   status;   // <stat> of CREG/CGREG/CEREG, -1 if unknown
+  uint32_t area;     // LAC or TAC, 0 if not reported
+  uint32_t cell_id;  // 0 if not reported
+  int8_t   act;      // Access technology, -1 if not reported
+};
+
 template <class modemType>
 class TinyGsmModem {
   /* =========================================== */
@@ -357,9 +378,34 @@ class TinyGsmModem {
    * @return *false* The module is not connected to the network
    */
   bool isNetworkConnected() {
+    // With registration reports on this is read from memory
+    if (reg_reports) { return registrationOk(); }
     return thisModem().isNetworkConnectedImpl();
   }
 
+  /**
+   * @brief Get the last registration state, with location and access
+   * technology, reported by the module.  The state of the domain the module
+   * is registered on is returned; EPS first, then packet and then circuit
+   * switched.
+   *
+   * @return *TinyGsmRegistration* The registration state; the status is -1 if
+   * the module doesn't send registration reports.
+   */
+  TinyGsmRegistration getRegistrationInfo() {
+    TinyGsmRegistration info = {-1, 0, 0, -1};
+    if (!reg_reports) { return info; }
+    registrationOk();  // Picks up any waiting reports
+    for (int8_t i = 2; i >= 0; i--) {
+      if (!(reg_reports & (1 << i))) { continue; }
+      if (info.status < 0 || isRegistered(reg_info[i].status)) {
+        info = reg_info[i];
+      }
+      if (isRegistered(info.status)) { break; }
+    }
+    return info;
+  }
+
   /**
    * @brief Wait until the module has connected to the network
    *
@@ -394,7 +440,11 @@ class TinyGsmModem {
    * @return *String* The local IP address
    */
   String getLocalIP() {
-    return thisModem().getLocalIPImpl();
+    // Kept while PDP context events say the context is still up
+    if (pdp_state == 1 && pdp_ip.length()) { return pdp_ip; }
+    String ip = thisModem().getLocalIPImpl();
+    if (pdp_state == 1) { pdp_ip = ip; }
+    return ip;
   }
 
   /**
@@ -421,6 +471,8 @@ class TinyGsmModem {
     return static_cast<modemType&>(*this);
   }
   /**@}*/
+  TinyGsmModem()
+      : reg_reports(0), reg_check(0), pdp_events(false), pdp_state(-1) {}
   ~TinyGsmModem() {}
 
 
@@ -650,7 +702,11 @@ class TinyGsmModem {
           goto finish;
         }
 #endif
-        else if (thisModem().handleURCs(data)) {
+        else if (reg_reports && handleRegistrationURC(data)) {
+          data = "";
+        } else if (pdp_events && handlePdpURC(data)) {
+          data = "";
+        } else if (thisModem().handleURCs(data)) {
           data = "";
         }
       }
@@ -742,7 +798,8 @@ class TinyGsmModem {
  protected:
   bool radioOffImpl() {
     if (!thisModem().setPhoneFunctionality(0)) { return false; }
-    delay(3000);
+    // Done once the SIM has been powered down
+    thisModem().waitResponse(3000L, GF("+CPIN: NOT READY"));
     return true;
   }
 
@@ -760,15 +817,34 @@ class TinyGsmModem {
   // CGREG = GPRS service registration
   // CEREG = EPS registration for LTE modules
   int8_t getRegistrationStatusXREG(const char* regCommand) {
+    uint8_t domain = regDomain(regCommand);
     thisModem().sendAT('+', regCommand, '?');
-    // check for any of the three for simplicity
-    int8_t resp = thisModem().waitResponse(GF("+CREG:"), GF("+CGREG:"),
-                                           GF("+CEREG:"));
-    if (resp != 1 && resp != 2 && resp != 3) { return -1; }
-    thisModem().streamSkipUntil(','); /* Skip format (0) */
-    int status = thisModem().stream.parseInt();
+    for (;;) {
+      int8_t resp = thisModem().waitResponse(GF("+CREG:"), GF("+CGREG:"),
+                                             GF("+CEREG:"));
+      if (resp != 1 && resp != 2 && resp != 3) { return -1; }
+      // A report for another domain, or a URC, can come before the answer
+      if (streamGetRegistration(resp - 1) && resp - 1 == domain) { break; }
+    }
     thisModem().waitResponse();
-    return status;
+    return reg_info[domain].status;
+  }
+
+  // Turns on registration reports, with location, for the given domains and
+  // reads the current state of each.  Once on, isNetworkConnected() is
+  // answered from the reports rather than by asking the module.
+  bool enableRegistrationReports(uint8_t reports) {
+    static const char* const commands[] = {"CREG", "CGREG", "CEREG"};
+    reg_reports = 0;
+    for (uint8_t i = 0; i < 3; i++) {
+      if (!(reports & (1 << i))) { continue; }
+      thisModem().sendAT('+', commands[i], GF("=2"));
+      if (thisModem().waitResponse() != 1) { continue; }
+      if (getRegistrationStatusXREG(commands[i]) < 0) { continue; }
+      reg_reports |= 1 << i;
+    }
+    reg_check = millis();
+    return reg_reports == reports;
   }
 
   bool waitForNetworkImpl(uint32_t timeout_ms   = 60000L,
@@ -776,11 +852,151 @@ class TinyGsmModem {
     for (uint32_t start = millis(); millis() - start < timeout_ms;) {
       if (check_signal) { thisModem().getSignalQuality(); }
       if (thisModem().isNetworkConnected()) { return true; }
-      delay(250);
+      if (!reg_reports) {
+        delay(250);
+        continue;
+      }
+      // Registration changes come as URCs, so just wait for something to
+      // arrive
+      for (uint32_t wait = millis();
+           !thisModem().stream.available() && millis() - wait < 250;) {
+        TINY_GSM_YIELD();
+      }
+    }
+    return false;
+  }
+
+  static bool isRegistered(int8_t status) {
+    return status == 1 || status == 5;  // Home or roaming
+  }
+
+  // Registered in any domain with reports on, after reading any waiting
+  // reports.  A module that restarted on its own has its reports off again,
+  // so when none has come for a while they're turned back on and the state is
+  // read again.
+  bool registrationOk() {
+    thisModem().streamClear();
+    if (millis() - reg_check > TINY_GSM_REG_CHECK_INTERVAL) {
+      enableRegistrationReports(reg_reports);
+    }
+    for (uint8_t i = 0; i < 3; i++) {
+      if ((reg_reports & (1 << i)) && isRegistered(reg_info[i].status)) {
+        return true;
+      }
     }
     return false;
   }
 
+  // CREG = 0, CGREG = 1, CEREG = 2
+  static uint8_t regDomain(const char* regCommand) {
+    return regCommand[1] == 'E' ? 2 : regCommand[1] == 'G' ? 1 : 0;
+  }
+
+  bool handleRegistrationURC(String& data) {
+    int8_t domain = -1;
+    if (data.endsWith(GF("+CREG:"))) {
+      domain = 0;
+    } else if (data.endsWith(GF("+CGREG:"))) {
+      domain = 1;
+    } else if (data.endsWith(GF("+CEREG:"))) {
+      domain = 2;
+    }
+    if (domain < 0) { return false; }
+    streamGetRegistration(domain);
+    reg_check = millis();
+    DBG("### Registration:", reg_info[domain].status);
+    return true;
+  }
+
+  // Reads the rest of a CREG/CGREG/CEREG line into the cache.  Returns true if
+  // it was the answer to a query, which starts with <n>, rather than a URC,
+  // which starts with <stat>.
+  bool streamGetRegistration(uint8_t domain) {
+    String line = thisModem().stream.readStringUntil('\n');
+    line.trim();
+    int  comma     = line.indexOf(',');
+    bool solicited = comma > 0 && isDigit(line.charAt(comma + 1));
+    if (solicited) { line.remove(0, comma + 1); }
+
+    TinyGsmRegistration& r = reg_info[domain];
+    r.status               = line.toInt();
+    r.area                 = 0;
+    r.cell_id              = 0;
+    r.act                  = -1;
+    // [,"<lac/tac>","<ci>"[,<AcT>...]]
+    uint32_t* fields[] = {&r.area, &r.cell_id};
+    for (uint8_t f = 0; f < 3; f++) {
+      comma = line.indexOf(',');
+      if (comma < 0) { break; }
+      line.remove(0, comma + 1);
+      if (f < 2) {
+        const char* hex = line.c_str();
+        if (*hex == '"') { hex++; }
+        *fields[f] = strtoul(hex, nullptr, 16);
+      } else if (isDigit(line.charAt(0))) {
+        r.act = line.toInt();
+      }
+    }
+    return solicited;
+  }
+
+  // Turns on +CGEV packet domain events, so the state of the PDP context and
+  // its address can be kept rather than asked for on every check.
+  bool enablePdpEvents() {
+    pdpChanged(-1);
+    pdp_events = false;
+    thisModem().sendAT(GF("+CGEREP=2,1"));
+    if (thisModem().waitResponse() != 1) {
+      thisModem().sendAT(GF("+CGEREP=1"));
+      if (thisModem().waitResponse() != 1) { return false; }
+    }
+    pdp_events = true;
+    return true;
+  }
+
+  // Records the PDP context state: 1 up, 0 down, -1 unknown (ask the module
+  // on the next check).  The address is asked for again after any change.
+  void pdpChanged(int8_t state) {
+    pdp_state = state;
+    pdp_ip    = "";
+  }
+
+  bool handlePdpURC(String& data) {
+    if (!data.endsWith(GF("+CGEV:"))) { return false; }
+    String event = thisModem().stream.readStringUntil('\n');
+    event.trim();
+    // ME/NW [PDN] <what> [<args>]
+    int  word = event.indexOf(' ');
+    bool pdn  = event.substring(word + 1).startsWith("PDN ");
+    if (pdn) { word = event.indexOf(' ', word + 1); }
+    int    end  = event.indexOf(' ', word + 1);
+    String what = end > 0 ? event.substring(word + 1, end)
+                          : event.substring(word + 1);
+    String args = end > 0 ? event.substring(end + 1) : "";
+    if (what == "DETACH") {
+      pdpChanged(0);
+    } else if (what == "ACT" || what == "DEACT") {
+      // PDN ACT/DEACT <cid> or, before LTE, ACT/DEACT <PDP_type>,<PDP_addr>
+      // [,<cid>].  Other ACT/DEACT events are for dedicated bearers, which
+      // leave the default one as it is.
+      int8_t cid = -1;
+      if (pdn) {
+        cid = args.toInt();
+      } else if (args.startsWith("\"")) {
+        int comma = args.indexOf(',', args.indexOf(',') + 1);
+        cid       = comma > 0 ? args.substring(comma + 1).toInt() : 0;
+      }
+      // Only the data context, 1, counts; without a cid ask again
+      if (cid == 1) {
+        pdpChanged(what == "ACT" ? 1 : 0);
+      } else if (cid == 0) {
+        pdpChanged(-1);
+      }
+    }
+    DBG("### PDP event:", event);
+    return true;
+  }
+
   // Gets signal quality report according to 3GPP TS command AT+CSQ
   int8_t getSignalQualityImpl() {
     thisModem().sendAT(GF("+CSQ"));
@@ -798,6 +1014,13 @@ class TinyGsmModem {
     if (thisModem().waitResponse() != 1) { return ""; }
     return res;
   }
+
+  TinyGsmRegistration reg_info[3];  // CREG, CGREG, CEREG
+  uint8_t             reg_reports;  // RegistrationReport flags turned on
+  uint32_t            reg_check;    // Last report or query of the state
+  bool                pdp_events;   // +CGEREP turned on
+  int8_t              pdp_state;    // See pdpChanged()
+  String              pdp_ip;
 };
 
 #endif  // SRC_TINYGSMMODEM_H_
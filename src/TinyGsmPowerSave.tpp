@@ -0,0 +1,263 @@
+/**
+ * @file       TinyGsmPowerSave.tpp
+ * @author     Volodymyr Shymanskyy
+ * @license    LGPL-3.0
+ * @copyright  Copyright (c) 2016 Volodymyr Shymanskyy
+ * @date       Oct 2026
+ */
+
+#ifndef SRC_TINYGSMPOWERSAVE_H_
+#define SRC_TINYGSMPOWERSAVE_H_
+
+#include "TinyGsmCommon.h"
+
+#define TINY_GSM_MODEM_HAS_POWER_SAVE
+
+// Access technology for eDRX, as in AT+CEDRXS
+enum EDRXAct {
+  EDRX_LTE_M  = 4,  // E-UTRAN WB-S1 mode
+  EDRX_NB_IOT = 5,  // E-UTRAN NB-S1 mode
+};
+
+// eDRX cycle lengths, 3GPP TS 24.008 table 10.5.5.32.  The ones below 20.48 s
+// are LTE-M only.
+enum EDRXCycle {
+  EDRX_CYCLE_5_12_S     = 0,
+  EDRX_CYCLE_10_24_S    = 1,
+  EDRX_CYCLE_20_48_S    = 2,
+  EDRX_CYCLE_40_96_S    = 3,
+  EDRX_CYCLE_81_92_S    = 5,
+  EDRX_CYCLE_163_84_S   = 9,
+  EDRX_CYCLE_327_68_S   = 10,
+  EDRX_CYCLE_655_36_S   = 11,
+  EDRX_CYCLE_1310_72_S  = 12,
+  EDRX_CYCLE_2621_44_S  = 13,
+  EDRX_CYCLE_5242_88_S  = 14,
+  EDRX_CYCLE_10485_76_S = 15,
+};
+
+template <class modemType>
+class TinyGsmPowerSave {
+  /* =========================================== */
+  /* =========================================== */
+  /*
+   * Define the interface
+   */
+ public:
+  /*
+   * Power saving mode (PSM) functions
+   */
+  // Requests PSM with the given periodic TAU (T3412) and active time (T3324)
+  // in seconds, rounded up to what the timers can hold.  A time of 0 leaves
+  // the timer to the module and network.
+  bool setPSM(bool enable, uint32_t tau_s = 0, uint32_t active_s = 0) {
+    return thisModem().setPSMImpl(enable, tau_s, active_s);
+  }
+
+  // Gets the periodic TAU and active time granted by the network, in seconds
+  bool getPSM(uint32_t& tau_s, uint32_t& active_s) {
+    return thisModem().getPSMImpl(tau_s, active_s);
+  }
+
+  // Whether the module is in PSM, from its URCs: 1 in PSM, 0 awake, -1 unknown
+  // or the module doesn't report it
+  int8_t getPSMState() {
+    return psm_state;
+  }
+
+  /*
+   * Extended discontinuous reception (eDRX) functions
+   */
+  // Requests an eDRX cycle and, on modules with a command for it, a paging
+  // time window (PTW, 0-15 in steps of 1.28 s on LTE-M or 2.56 s on NB-IoT;
+  // -1 leaves it to the module)
+  bool setEDRX(bool enable, EDRXAct act, EDRXCycle cycle = EDRX_CYCLE_81_92_S,
+               int8_t ptw = -1) {
+    return thisModem().setEDRXImpl(enable, act, cycle, ptw);
+  }
+
+  // Gets the eDRX cycle and PTW granted by the network
+  bool getEDRX(uint8_t& cycle, uint8_t& ptw) {
+    return thisModem().getEDRXImpl(cycle, ptw);
+  }
+
+  /*
+   * Timer encoding, 3GPP TS 24.008 10.5.7.4a and 10.5.7.3
+   */
+  static uint8_t encodeT3412(uint32_t seconds) {
+    static const uint32_t units[] = {2, 30, 60, 600, 3600, 36000, 1152000};
+    static const uint8_t  codes[] = {3, 4, 5, 0, 1, 2, 6};
+    return encodeTimer(seconds, units, codes, 7);
+  }
+
+  static uint32_t decodeT3412(uint8_t timer) {
+    static const uint32_t units[] = {600, 3600, 36000, 2, 30, 60, 1152000};
+    uint8_t               unit    = timer >> 5;
+    if (unit == 7) { return 0; }  // Deactivated
+    return units[unit] * (timer & 0x1F);
+  }
+
+  static uint8_t encodeT3324(uint32_t seconds) {
+    static const uint32_t units[] = {2, 60, 360};
+    static const uint8_t  codes[] = {0, 1, 2};
+    return encodeTimer(seconds, units, codes, 3);
+  }
+
+  static uint32_t decodeT3324(uint8_t timer) {
+    uint8_t unit = timer >> 5;
+    if (unit == 7) { return 0; }  // Deactivated
+    // Other units are read as minutes
+    return (unit == 0 ? 2 : unit == 2 ? 360 : 60) * (timer & 0x1F);
+  }
+
+  /*
+   * CRTP Helper
+   */
+ protected:
+  inline const modemType& thisModem() const {
+    return static_cast<const modemType&>(*this);
+  }
+  inline modemType& thisModem() {
+    return static_cast<modemType&>(*this);
+  }
+  TinyGsmPowerSave() : psm_state(-1) {}
+  ~TinyGsmPowerSave() {}
+
+  /* =========================================== */
+  /* =========================================== */
+  /*
+   * Define the default function implementations
+   */
+
+  /*
+   * Power saving mode (PSM) functions
+   */
+ protected:
+  // Uses 3GPP TS 27.007 AT+CPSMS
+  bool setPSMImpl(bool enable, uint32_t tau_s, uint32_t active_s) {
+    if (!enable) {
+      thisModem().sendAT(GF("+CPSMS=0"));
+    } else {
+      // An empty parameter leaves the timer as it is
+      String tau, active;
+      if (tau_s) { tau = quoted(bitString(encodeT3412(tau_s), 8)); }
+      if (active_s) { active = quoted(bitString(encodeT3324(active_s), 8)); }
+      thisModem().sendAT(GF("+CPSMS=1,,,"), tau, ',', active);
+    }
+    if (thisModem().waitResponse() != 1) { return false; }
+    if (!enable) { psm_state = -1; }
+    return thisModem().psmReportsImpl(enable);
+  }
+
+  // Turns the module's URCs for entering and leaving PSM on or off.  Modules
+  // without such URCs have nothing to do.
+  bool psmReportsImpl(bool) {
+    return true;
+  }
+
+  // Reads the granted timers from AT+CEREG with <n> = 4, then puts the
+  // registration reports back
+  bool getPSMImpl(uint32_t& tau_s, uint32_t& active_s) {
+    thisModem().sendAT(GF("+CEREG=4"));
+    if (thisModem().waitResponse() != 1) { return false; }
+    thisModem().sendAT(GF("+CEREG?"));
+    String line;
+    if (thisModem().waitResponse(GF("+CEREG:")) == 1) {
+      line = thisModem().stream.readStringUntil('\n');
+      thisModem().waitResponse();
+    }
+    thisModem().sendAT(GF("+CEREG="),
+                       thisModem().reg_reports & REG_REPORT_CEREG ? 2 : 0);
+    thisModem().waitResponse();
+
+    // <n>,<stat>,[<tac>],[<ci>],[<AcT>],[<cause_type>],[<reject_cause>],
+    // [<Active-Time>],[<Periodic-TAU>]
+    String active = csvField(line, 7);
+    String tau    = csvField(line, 8);
+    if (!active.length() || !tau.length()) { return false; }
+    active_s = decodeT3324(strtoul(active.c_str(), nullptr, 2));
+    tau_s    = decodeT3412(strtoul(tau.c_str(), nullptr, 2));
+    return true;
+  }
+
+  /*
+   * Extended discontinuous reception (eDRX) functions
+   */
+ protected:
+  // Uses 3GPP TS 27.007 AT+CEDRXS, which has no PTW
+  bool setEDRXImpl(bool enable, EDRXAct act, EDRXCycle cycle, int8_t ptw) {
+    if (!enable) {
+      thisModem().sendAT(GF("+CEDRXS=0,"), act);
+    } else {
+      thisModem().sendAT(GF("+CEDRXS=1,"), act, ',',
+                         quoted(bitString(cycle, 4)));
+    }
+    if (thisModem().waitResponse() != 1) { return false; }
+    if (enable && ptw >= 0) {
+      DBG("### PTW can't be set on this module");
+      return false;
+    }
+    return true;
+  }
+
+  // Uses 3GPP TS 27.007 AT+CEDRXRDP
+  bool getEDRXImpl(uint8_t& cycle, uint8_t& ptw) {
+    thisModem().sendAT(GF("+CEDRXRDP"));
+    if (thisModem().waitResponse(GF("+CEDRXRDP:")) != 1) { return false; }
+    String line = thisModem().stream.readStringUntil('\n');
+    thisModem().waitResponse();
+    // <AcT-type>[,<Requested_eDRX_value>[,<NW-provided_eDRX_value>
+    // [,<Paging_time_window>]]]
+    String granted = csvField(line, 2);
+    String window  = csvField(line, 3);
+    if (line.toInt() == 0 || !granted.length()) { return false; }
+    cycle = strtoul(granted.c_str(), nullptr, 2);
+    ptw   = strtoul(window.c_str(), nullptr, 2);
+    return true;
+  }
+
+  /*
+   * Utilities
+   */
+ protected:
+  static uint8_t encodeTimer(uint32_t seconds, const uint32_t units[],
+                             const uint8_t codes[], uint8_t count) {
+    for (uint8_t i = 0; i < count; i++) {
+      uint32_t value = (seconds + units[i] - 1) / units[i];
+      if (value <= 31) { return (codes[i] << 5) | value; }
+    }
+    return (codes[count - 1] << 5) | 31;
+  }
+
+  static String bitString(uint8_t value, uint8_t bits) {
+    String res;
+    res.reserve(bits);
+    for (int8_t i = bits - 1; i >= 0; i--) {
+      res += ((value >> i) & 1) ? '1' : '0';
+    }
+    return res;
+  }
+
+  static String quoted(const String& value) {
+    return String('"') + value + '"';
+  }
+
+  // The field at the index of a comma separated line, without quotes
+  static String csvField(const String& line, uint8_t index) {
+    int start = 0;
+    for (uint8_t i = 0; i < index; i++) {
+      start = line.indexOf(',', start);
+      if (start < 0) { return ""; }
+      start++;
+    }
+    int    end   = line.indexOf(',', start);
+    String field = line.substring(start, end < 0 ? line.length() : end);
+    field.trim();
+    field.replace("\"", "");
+    return field;
+  }
+
+  int8_t psm_state;
+};
+
+#endif  // SRC_TINYGSMPOWERSAVE_H_
@@ -55,12 +55,7 @@ class TinyGsmSMS {
     byte   reminder = 0;
     int8_t bitstate = 7;
     for (uint8_t i = 0; i < instr.length(); i += 2) {
-      char buf[4] = {
-          0,
-      };
-      buf[0] = instr[i];
-      buf[1] = instr[i + 1];
-      byte b = strtol(buf, nullptr, 16);
+      byte b = TinyGsmHexToByte(instr[i], instr[i + 1]);
 
       byte bb = b << (7 - bitstate);
       char c  = (bb + reminder) & 0x7F;
@@ -79,14 +74,9 @@ class TinyGsmSMS {
 
   static inline String TinyGsmDecodeHex8bit(String& instr) {
     String result;
+    result.reserve(instr.length() / 2);
     for (uint16_t i = 0; i < instr.length(); i += 2) {
-      char buf[4] = {
-          0,
-      };
-      buf[0] = instr[i];
-      buf[1] = instr[i + 1];
-      char b = strtol(buf, nullptr, 16);
-      result += b;
+      result += static_cast<char>(TinyGsmHexToByte(instr[i], instr[i + 1]));
     }
     return result;
   }
@@ -94,12 +84,7 @@ class TinyGsmSMS {
   static inline String TinyGsmDecodeHex16bit(String& instr) {
     String result;
     for (uint16_t i = 0; i < instr.length(); i += 4) {
-      char buf[4] = {
-          0,
-      };
-      buf[0] = instr[i];
-      buf[1] = instr[i + 1];
-      char b = strtol(buf, nullptr, 16);
+      char b = TinyGsmHexToByte(instr[i], instr[i + 1]);
       if (b) {  // If high byte is non-zero, we can't handle it ;(
 #if defined(TINY_GSM_UNICODE_TO_HEX)
         result += "\\x";
@@ -108,9 +93,7 @@ class TinyGsmSMS {
         result += "?";
 #endif
       } else {
-        buf[0] = instr[i + 2];
-        buf[1] = instr[i + 3];
-        b      = strtol(buf, nullptr, 16);
+        b = TinyGsmHexToByte(instr[i + 2], instr[i + 3]);
         result += b;
       }
     }
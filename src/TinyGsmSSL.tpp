@@ -11,8 +11,108 @@
 
 #include "TinyGsmCommon.h"
 
+// Drivers include TinyGsmTCP.tpp, for TinyGsmSendSource, before this
+
 #define TINY_GSM_MODEM_HAS_SSL
 
+// TLS versions for a TinyGsmTLSProfile
+enum TLSVersion {
+  TLS_VERSION_ANY = 0,
+  TLS_VERSION_1_0 = 1,
+  TLS_VERSION_1_1 = 2,
+  TLS_VERSION_1_2 = 3,
+  TLS_VERSION_1_3 = 4,
+};
+
+/*
+ * What a secure socket negotiates.  The defaults ask for TLS 1.2 with every
+ * cipher suite the module has; that lets a server pick a fast ECDHE/AES-GCM
+ * suite where the module supports one.  Versions below TLS 1.2 are only
+ * offered when the profile asks for them.
+ */
+struct TinyGsmTLSProfile {
+  TinyGsmTLSProfile()
+      : min_version(TLS_VERSION_ANY),
+        max_version(TLS_VERSION_ANY),
+        cipher_suite(0),
+        sni(true) {}
+
+  TLSVersion min_version;
+  TLSVersion max_version;
+  // The IANA number of the one cipher suite to use, ie, 0xC02F for
+  // TLS_ECDHE_RSA_WITH_AES_128_GCM_SHA256, or 0 for all the module has
+  uint16_t cipher_suite;
+  // Send the host name for server name indication
+  bool sni;
+
+  // The one version to ask the module for, or TLS_VERSION_ANY for a range
+  TLSVersion version() const {
+    return min_version == max_version ? min_version : TLS_VERSION_ANY;
+  }
+
+  // The version for modules that take either one version or all of them,
+  // with 4 for all: the one version asked for, at most TLS 1.2, or else
+  // TLS 1.2 unless the profile allows older versions
+  uint8_t versionOrAll() const {
+    TLSVersion one = version();
+    if (one != TLS_VERSION_ANY) {
+      return one > TLS_VERSION_1_2 ? TLS_VERSION_1_2 : one;
+    }
+    TLSVersion lowest = min_version != TLS_VERSION_ANY ? min_version
+                                                       : max_version;
+    return lowest != TLS_VERSION_ANY && lowest < TLS_VERSION_1_2
+        ? 4
+        : TLS_VERSION_1_2;
+  }
+};
+
+// The settings of a module's SSL contexts that drivers keep track of
+enum SSLConfigKey {
+  SSL_CFG_VERSION  = 0,
+  SSL_CFG_CIPHERS  = 1,
+  SSL_CFG_SECLEVEL = 2,
+  SSL_CFG_CACERT   = 3,
+  SSL_CFG_SNI      = 4,
+  SSL_CFG_ENABLED  = 5,
+  SSL_CFG_COUNT    = 6,
+};
+
+/*
+ * The settings last applied to each of a module's SSL contexts, so that a
+ * connect need only send the ones that changed.  Values are kept as hashes.
+ * The driver clears it from init(), since a restart loses the settings.
+ */
+template <uint8_t contexts>
+class TinyGsmSSLConfigCache {
+ public:
+  TinyGsmSSLConfigCache() {
+    clear();
+  }
+
+  // Whether a setting must be sent, ie, its value isn't the one last applied.
+  // The value is recorded straight away, so clear() the cache if the module
+  // then rejects it.
+  bool needs(uint8_t ctx, SSLConfigKey key, const char* value) {
+    if (ctx >= contexts) { return true; }
+    // FNV-1a, with 0 kept for "unknown"
+    uint32_t hash = 2166136261UL;
+    while (*value) {
+      hash = (hash ^ static_cast<uint8_t>(*value++)) * 16777619UL;
+    }
+    if (hash == 0) { hash = 1; }
+    if (applied[ctx][key] == hash) { return false; }
+    applied[ctx][key] = hash;
+    return true;
+  }
+
+  void clear() {
+    memset(applied, 0, sizeof(applied));
+  }
+
+ protected:
+  uint32_t applied[contexts][SSL_CFG_COUNT];
+};
+
 template <class modemType, uint8_t muxCount>
 class TinyGsmSSL {
   /* =========================================== */
@@ -38,6 +138,16 @@ class TinyGsmSSL {
                       const uint16_t len) {
     return addCertificate(certificateName.c_str(), cert.c_str(), len);
   }
+  // Uploads len bytes of a certificate read from a stream (ie, a file), a
+  // chunk at a time.  If the module already has a file of that name and size
+  // the upload is skipped, sparing the module's flash; set replace to upload
+  // a certificate that may have changed without changing size.
+  bool addCertificate(const char* certificateName, Stream& cert, size_t len,
+                      bool replace = false) {
+    TinyGsmStreamSource source(cert);
+    return thisModem().addCertificateImpl(certificateName, source, len,
+                                          replace);
+  }
 
   bool deleteCertificate(const char* filename) {
     return thisModem().deleteCertificateImpl(filename);
@@ -49,6 +159,14 @@ class TinyGsmSSL {
     return true;
   }
 
+  // The TLS versions, cipher suite and SNI for the socket on this mux.  The
+  // settings are applied as it connects.
+  bool setTLSProfile(const TinyGsmTLSProfile& profile, const uint8_t mux = 0) {
+    if (mux >= muxCount) return false;
+    tls_profiles[mux] = profile;
+    return true;
+  }
+
   /*
    * CRTP Helper
    */
@@ -74,10 +192,14 @@ class TinyGsmSSL {
   bool addCertificateImpl(const char* filename) TINY_GSM_ATTR_NOT_IMPLEMENTED;
   bool addCertificateImpl(const char* certificateName, const char* cert,
                           const uint16_t len) TINY_GSM_ATTR_NOT_IMPLEMENTED;
+  bool addCertificateImpl(const char* certificateName, TinyGsmSendSource& cert,
+                          size_t len,
+                          bool   replace) TINY_GSM_ATTR_NOT_IMPLEMENTED;
   bool
   deleteCertificateImpl(const char* filename) TINY_GSM_ATTR_NOT_IMPLEMENTED;
 
-  String certificates[muxCount];
+  String            certificates[muxCount];
+  TinyGsmTLSProfile tls_profiles[muxCount];
 };
 
 #endif  // SRC_TINYGSMSSL_H_
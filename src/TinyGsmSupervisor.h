@@ -0,0 +1,335 @@
+/**
+ * @file       TinyGsmSupervisor.h
+ * @author     Volodymyr Shymanskyy
+ * @license    LGPL-3.0
+ * @copyright  Copyright (c) 2016 Volodymyr Shymanskyy
+ * @date       Oct 2026
+ */
+
+#ifndef SRC_TINYGSMSUPERVISOR_H_
+#define SRC_TINYGSMSUPERVISOR_H_
+
+#include "TinyGsmCommon.h"
+#include "TinyGsmGPRS.tpp"
+
+// How often a connection that is up is checked
+#ifndef TINY_GSM_SUPERVISOR_CHECK_INTERVAL
+#define TINY_GSM_SUPERVISOR_CHECK_INTERVAL 10000L
+#endif
+
+// The shortest and longest wait before a recovery step
+#ifndef TINY_GSM_SUPERVISOR_BACKOFF_MIN
+#define TINY_GSM_SUPERVISOR_BACKOFF_MIN 1000L
+#endif
+
+#ifndef TINY_GSM_SUPERVISOR_BACKOFF_MAX
+#define TINY_GSM_SUPERVISOR_BACKOFF_MAX 300000L
+#endif
+
+enum SupervisorState {
+  SUPERVISOR_MODEM_CHECK    = 0,  // Waiting for the modem to answer
+  SUPERVISOR_SIM_CHECK      = 1,  // Waiting for the SIM
+  SUPERVISOR_REGISTERING    = 2,  // Waiting for network registration
+  SUPERVISOR_PDP_CONNECTING = 3,  // Activating the PDP context
+  SUPERVISOR_CONNECTED      = 4,
+  SUPERVISOR_BACKOFF        = 5,  // Waiting before a recovery step
+  SUPERVISOR_SIM_LOCKED     = 6,  // The SIM needs a PIN or its PIN was wrong;
+                                  // stopped until setSimPin() is called
+};
+
+enum SupervisorRecovery {
+  RECOVERY_NONE    = 0,
+  RECOVERY_PDP     = 1,  // Deactivate and activate the PDP context
+  RECOVERY_CFUN    = 2,  // Turn the radio off and on again
+  RECOVERY_RESTART = 3,  // Restart the modem
+};
+
+/*
+ * Keeps a cellular modem connected without blocking the sketch.  Call run()
+ * from loop(); each call takes at most one step through checking the modem
+ * and SIM, waiting for registration and activating the PDP context, and once
+ * connected the connection is checked every
+ * TINY_GSM_SUPERVISOR_CHECK_INTERVAL.
+ *
+ *   TinyGsmSupervisor<TinyGsm> supervisor(modem, apn);
+ *
+ *   void loop() {
+ *     if (!supervisor.run()) { return; }
+ *     if (!client.connected() && !client.connect(server, port)) {
+ *       supervisor.socketFailed();
+ *       return;
+ *     }
+ *     supervisor.socketOk();
+ *     // ...
+ *   }
+ *
+ * Failures are recovered from a step at a time.  The sketch reconnects its
+ * own sockets; after a few failed sockets in a row, or when a step fails, the
+ * PDP context is re-activated, then the radio is cycled with CFUN and then
+ * the modem is restarted.  Each step waits a doubling, jittered time first.
+ * Activating the PDP context and restarting the modem block for as long as
+ * the modem takes.  A SIM that stays locked after its PIN was tried stops
+ * the supervisor in SUPERVISOR_SIM_LOCKED.  Start the supervisor after the
+ * modem's init().
+ */
+template <class modemType>
+class TinyGsmSupervisor {
+ public:
+  TinyGsmSupervisor(modemType& modem, const char* apn,
+                    const char* user = nullptr, const char* pwd = nullptr)
+      : at(&modem),
+        apn(apn),
+        user(user),
+        pwd(pwd),
+        pin(nullptr),
+        pin_tried(false),
+        check_interval(TINY_GSM_SUPERVISOR_CHECK_INTERVAL),
+        backoff_min(TINY_GSM_SUPERVISOR_BACKOFF_MIN),
+        backoff_max(TINY_GSM_SUPERVISOR_BACKOFF_MAX),
+        step_timeout(10000L),
+        reg_timeout(180000L),
+        max_socket_failures(3),
+        state(SUPERVISOR_MODEM_CHECK),
+        level(RECOVERY_NONE),
+        attempts(0),
+        socket_failures(0),
+        entered(millis()),
+        last_poll(0),
+        poll_now(true),
+        backoff_ms(0) {
+    memset(state_time, 0, sizeof(state_time));
+    memset(recoveries, 0, sizeof(recoveries));
+  }
+
+  /*
+   * Set up
+   */
+  // The PIN to unlock the SIM with, and to pass to restart().  It is tried
+  // once each time the SIM asks for it, so a wrong PIN stops the supervisor
+  // in SUPERVISOR_SIM_LOCKED rather than using up the SIM's attempts; giving
+  // the PIN again starts it from the SIM check.
+  void setSimPin(const char* sim_pin) {
+    pin       = sim_pin;
+    pin_tried = false;
+    if (state == SUPERVISOR_SIM_LOCKED) { enter(SUPERVISOR_SIM_CHECK); }
+  }
+
+  void setCheckInterval(uint32_t interval_ms) {
+    check_interval = interval_ms;
+  }
+
+  void setBackoff(uint32_t min_ms, uint32_t max_ms) {
+    backoff_min = min_ms;
+    backoff_max = max_ms;
+  }
+
+  // How long to wait for the modem and the SIM, and for registration, before
+  // a recovery step
+  void setTimeouts(uint32_t step_timeout_ms, uint32_t reg_timeout_ms) {
+    step_timeout = step_timeout_ms;
+    reg_timeout  = reg_timeout_ms;
+  }
+
+  // How many failed sockets in a row re-activate the PDP context
+  void setMaxSocketFailures(uint8_t failures) {
+    max_socket_failures = failures;
+  }
+
+  /*
+   * Running
+   */
+  // Takes the next step; returns true while connected
+  bool run() {
+    switch (state) {
+      case SUPERVISOR_MODEM_CHECK:
+        if (!poll(1000L)) { break; }
+        if (at->testAT(1000L)) {
+          enter(SUPERVISOR_SIM_CHECK);
+        } else if (millis() - entered > step_timeout) {
+          fail(RECOVERY_RESTART);
+        }
+        break;
+
+      case SUPERVISOR_SIM_CHECK: {
+        if (!poll(1000L)) { break; }
+        SimStatus sim = at->getSimStatus(1000L);
+        if (sim == SIM_LOCKED && pin != nullptr && !pin_tried) {
+          pin_tried = true;
+          at->simUnlock(pin);
+        } else if (sim == SIM_LOCKED) {
+          DBG("### Supervisor: SIM locked");
+          enter(SUPERVISOR_SIM_LOCKED);
+        } else if (sim == SIM_READY) {
+          // A CFUN cycle or restart locks the SIM again, so the PIN is
+          // needed once more then
+          pin_tried = false;
+          enter(SUPERVISOR_REGISTERING);
+        } else if (millis() - entered > step_timeout) {
+          fail(RECOVERY_CFUN);
+        }
+        break;
+      }
+
+      case SUPERVISOR_REGISTERING:
+        if (!poll(1000L)) { break; }
+        if (at->isNetworkConnected()) {
+          enter(SUPERVISOR_PDP_CONNECTING);
+        } else if (millis() - entered > reg_timeout) {
+          fail(RECOVERY_CFUN);
+        }
+        break;
+
+      case SUPERVISOR_PDP_CONNECTING:
+        if (at->gprsConnect(apn, user, pwd)) {
+          enter(SUPERVISOR_CONNECTED);
+        } else {
+          fail(RECOVERY_PDP);
+        }
+        break;
+
+      case SUPERVISOR_CONNECTED:
+        if (!poll(check_interval)) { break; }
+        if (!at->isNetworkConnected()) {
+          enter(SUPERVISOR_REGISTERING);
+        } else if (!at->isGprsConnected()) {
+          enter(SUPERVISOR_PDP_CONNECTING);
+        } else {
+          // Stayed up, so the next failure starts from the bottom again
+          level    = RECOVERY_NONE;
+          attempts = 0;
+        }
+        break;
+
+      case SUPERVISOR_BACKOFF:
+        if (millis() - entered >= backoff_ms) { recover(); }
+        break;
+
+      case SUPERVISOR_SIM_LOCKED: break;
+    }
+    return state == SUPERVISOR_CONNECTED;
+  }
+
+  // Report a socket that couldn't connect or send
+  void socketFailed() {
+    if (++socket_failures < max_socket_failures) { return; }
+    socket_failures = 0;
+    if (state == SUPERVISOR_CONNECTED) { fail(RECOVERY_PDP); }
+  }
+
+  // Report a socket that works
+  void socketOk() {
+    socket_failures = 0;
+  }
+
+  /*
+   * State and metrics
+   */
+  SupervisorState getState() const {
+    return state;
+  }
+
+  bool isConnected() const {
+    return state == SUPERVISOR_CONNECTED;
+  }
+
+  // Total time spent in a state since the supervisor was made
+  uint32_t timeInState(SupervisorState s) const {
+    uint32_t t = state_time[s];
+    if (s == state) { t += millis() - entered; }
+    return t;
+  }
+
+  // Time since the current state was entered
+  uint32_t timeInCurrentState() const {
+    return millis() - entered;
+  }
+
+  // How many times a recovery step has been taken
+  uint16_t recoveryCount(SupervisorRecovery r) const {
+    return recoveries[r];
+  }
+
+ protected:
+  void enter(SupervisorState s) {
+    DBG("### Supervisor:", state, "->", s);
+    state_time[state] += millis() - entered;
+    state     = s;
+    entered   = millis();
+    last_poll = entered;
+    poll_now  = (s != SUPERVISOR_CONNECTED);
+  }
+
+  // True once every interval, and straight away on entering most states
+  bool poll(uint32_t interval_ms) {
+    if (!poll_now && millis() - last_poll < interval_ms) { return false; }
+    poll_now  = false;
+    last_poll = millis();
+    return true;
+  }
+
+  // Moves up to the next recovery step, or at least the one given, and waits
+  // before taking it
+  void fail(SupervisorRecovery at_least) {
+    uint8_t next = level + 1;
+    if (next < at_least) { next = at_least; }
+    if (next > RECOVERY_RESTART) { next = RECOVERY_RESTART; }
+    level = static_cast<SupervisorRecovery>(next);
+
+    // Doubles with each attempt; waits between half and all of that
+    uint32_t cap = backoff_min;
+    for (uint8_t i = 0; i < attempts && cap < backoff_max; i++) { cap *= 2; }
+    if (cap > backoff_max) { cap = backoff_max; }
+    backoff_ms = cap / 2 + random(cap / 2 + 1);
+    if (attempts < 255) { attempts++; }
+
+    DBG("### Supervisor: recovery", level, "in", backoff_ms, "ms");
+    enter(SUPERVISOR_BACKOFF);
+  }
+
+  void recover() {
+    recoveries[level]++;
+    switch (level) {
+      case RECOVERY_PDP:
+        at->gprsDisconnect();
+        enter(SUPERVISOR_PDP_CONNECTING);
+        break;
+      case RECOVERY_CFUN:
+        at->setPhoneFunctionality(0);
+        at->setPhoneFunctionality(1);
+        enter(SUPERVISOR_SIM_CHECK);
+        break;
+      case RECOVERY_RESTART:
+        at->restart(pin);
+        // init() has already tried the PIN if the SIM asked for it
+        pin_tried = (pin != nullptr);
+        enter(SUPERVISOR_MODEM_CHECK);
+        break;
+      default: enter(SUPERVISOR_MODEM_CHECK); break;
+    }
+  }
+
+  modemType*         at;
+  const char*        apn;
+  const char*        user;
+  const char*        pwd;
+  const char*        pin;
+  bool               pin_tried;
+  uint32_t           check_interval;
+  uint32_t           backoff_min;
+  uint32_t           backoff_max;
+  uint32_t           step_timeout;
+  uint32_t           reg_timeout;
+  uint8_t            max_socket_failures;
+  SupervisorState    state;
+  SupervisorRecovery level;
+  uint8_t            attempts;
+  uint8_t            socket_failures;
+  uint32_t           entered;
+  uint32_t           last_poll;
+  bool               poll_now;
+  uint32_t           backoff_ms;
+  uint32_t           state_time[SUPERVISOR_SIM_LOCKED + 1];
+  uint16_t           recoveries[RECOVERY_RESTART + 1];
+};
+
+#endif  // SRC_TINYGSMSUPERVISOR_H_
@@ -15,10 +15,30 @@
 
 #include "TinyGsmFifo.h"
 
+// The size of the receive buffer built into each client.  Set it to 0 when
+// every client gets its buffer from TinyGsmClientRx or setRxBuffer(), so the
+// clients carry no buffer of their own.
 #if !defined(TINY_GSM_RX_BUFFER)
 #define TINY_GSM_RX_BUFFER 64
 #endif
 
+// The most data to give the module in one send when sending from a Stream or
+// from several buffers
+#if !defined(TINY_GSM_SEND_MAX_SIZE)
+#define TINY_GSM_SEND_MAX_SIZE 1024
+#endif
+
+// The size of the chunks readInto() hands to its sink
+#if !defined(TINY_GSM_READ_INTO_CHUNK)
+#define TINY_GSM_READ_INTO_CHUNK 64
+#endif
+
+// How long connected() trusts the socket state it last got from the modem on
+// modules where it can't come from the buffer check, in milliseconds
+#if !defined(TINY_GSM_CONNECTED_CHECK_INTERVAL)
+#define TINY_GSM_CONNECTED_CHECK_INTERVAL 5000L
+#endif
+
 // Because of the ordering of resolution of overrides in templates, these need
 // to be written out every time.  This macro is to shorten that.
 #define TINY_GSM_CLIENT_CONNECT_OVERRIDES                             \
@@ -32,6 +52,20 @@
     return connect(ip, port, 75);                                     \
   }
 
+// What a module's socket commands allow, for the generic client code to take
+// the fastest path it can at compile time.  A driver whose module differs
+// declares its own `Traits` deriving from this one, hiding the one it gets
+// from TinyGsmTCP.
+struct TinyGsmTcpTraits {
+  // The most data to give the module in one send
+  static constexpr size_t maxSendSize = TINY_GSM_SEND_MAX_SIZE;
+  // The most data the module returns for one read command
+  static constexpr size_t maxReadSize = 0xFFFF;
+  // One query gets the buffered size of every socket, so maintain() asks once
+  // however many sockets have new data
+  static constexpr bool bulkAvailable = false;
+};
+
 // // For modules that do not store incoming data in any sort of buffer
 // #define TINY_GSM_NO_MODEM_BUFFER
 // // Data is stored in a buffer, but we can only read from the buffer,
@@ -41,6 +75,76 @@
 // // of the buffer
 // #define TINY_GSM_BUFFER_READ_AND_CHECK_SIZE
 
+// Options for a client write
+enum SendFlags {
+  SEND_NORMAL      = 0,
+  SEND_LAST_PACKET = 1,  // Nothing more will be sent, so the radio can be
+                         // released (Release Assistance Indication)
+};
+
+// The data for a send that isn't in a single buffer.  While one is set as the
+// modem's send_source, modemSend takes its data from here instead of buff.
+class TinyGsmSendSource {
+ public:
+  // Copies up to len bytes of the send into buf, returning how many
+  virtual size_t read(uint8_t* buf, size_t len) = 0;
+
+ protected:
+  ~TinyGsmSendSource() {}
+};
+
+// One of the buffers given to writev()
+struct TinyGsmIoVec {
+  const void* iov_base;
+  size_t      iov_len;
+};
+
+class TinyGsmIoVecSource : public TinyGsmSendSource {
+ public:
+  TinyGsmIoVecSource(const TinyGsmIoVec* iov, uint8_t iovcnt)
+      : iov(iov),
+        iovcnt(iovcnt),
+        offset(0) {}
+
+  size_t read(uint8_t* buf, size_t len) override {
+    size_t n = 0;
+    while (n < len && iovcnt) {
+      size_t chunk = TinyGsmMin(len - n, iov->iov_len - offset);
+      memcpy(buf + n, reinterpret_cast<const uint8_t*>(iov->iov_base) + offset,
+             chunk);
+      n += chunk;
+      offset += chunk;
+      if (offset == iov->iov_len) {
+        iov++;
+        iovcnt--;
+        offset = 0;
+      }
+    }
+    return n;
+  }
+
+ protected:
+  const TinyGsmIoVec* iov;
+  uint8_t             iovcnt;
+  size_t              offset;
+};
+
+// Called by readInto() with each chunk before it goes to the sink, ie: to keep
+// a running CRC of a download
+typedef void (*TinyGsmReadHook)(const uint8_t* data, size_t len, void* arg);
+
+class TinyGsmStreamSource : public TinyGsmSendSource {
+ public:
+  explicit TinyGsmStreamSource(Stream& src) : src(src) {}
+
+  size_t read(uint8_t* buf, size_t len) override {
+    return src.readBytes(reinterpret_cast<char*>(buf), len);
+  }
+
+ protected:
+  Stream& src;
+};
+
 template <class modemType, uint8_t muxCount>
 class TinyGsmTCP {
   /* =========================================== */
@@ -49,6 +153,8 @@ class TinyGsmTCP {
    * Define the interface
    */
  public:
+  typedef TinyGsmTcpTraits Traits;
+
   /*
    * Basic functions
    */
@@ -56,6 +162,20 @@ class TinyGsmTCP {
     return thisModem().maintainImpl();
   }
 
+  /*
+   * Client functions
+   */
+  // Connects each client to its host and port, returning how many connected.
+  // Modules that take another open command while one is still connecting
+  // open the sockets side by side, others connect them one after another.
+  template <class clientType>
+  uint8_t connectMany(clientType* clients[], const char* const hosts[],
+                      const uint16_t ports[], uint8_t count,
+                      int timeout_s = 75) {
+    return thisModem().connectManyImpl(clients, hosts, ports, count,
+                                       timeout_s);
+  }
+
   /*
    * CRTP Helper
    */
@@ -66,6 +186,7 @@ class TinyGsmTCP {
   inline modemType& thisModem() {
     return static_cast<modemType&>(*this);
   }
+  TinyGsmTCP() : send_source(nullptr) {}
   ~TinyGsmTCP() {}
 
   /*
@@ -75,6 +196,9 @@ class TinyGsmTCP {
   class GsmClient : public Client {
     // Make all classes created from the modem template friends
     friend class TinyGsmTCP<modemType, muxCount>;
+    // The connection pool checks the socket state directly
+    template <class, uint8_t>
+    friend class TinyGsmClientPool;
     typedef TinyGsmFifo<uint8_t, TINY_GSM_RX_BUFFER> RxFifo;
 
    public:
@@ -128,6 +252,57 @@ class TinyGsmTCP {
       return write((const uint8_t*)str, strlen(str));
     }
 
+    // Writes data out on the client, with SEND_LAST_PACKET telling the network
+    // that no more data is expected after it
+    size_t write(const uint8_t* buf, size_t size, SendFlags flags) {
+      if (!(flags & SEND_LAST_PACKET)) { return write(buf, size); }
+      TINY_GSM_YIELD();
+      at->maintain();
+      return at->modemSendLast(buf, size, mux);
+    }
+
+    // Sends len bytes read from src, handing them to the modem as it asks for
+    // them in sends of up to the module's maxSendSize.  Only what src already
+    // has is sent at a time, so the result is short if src runs dry for
+    // longer than the client's timeout.
+    size_t write(Stream& src, size_t len) {
+      TinyGsmStreamSource source(src);
+      size_t              sent = 0;
+      while (sent < len) {
+        uint32_t startMillis = millis();
+        while (!src.available() && millis() - startMillis < _timeout) {
+          TINY_GSM_YIELD();
+        }
+        size_t chunk = TinyGsmMin(
+            len - sent, static_cast<size_t>(modemType::Traits::maxSendSize));
+        chunk = TinyGsmMin(chunk, static_cast<size_t>(src.available()));
+        if (chunk == 0) { break; }
+        int16_t n = sendFrom(source, chunk);
+        if (n <= 0) { break; }
+        sent += n;
+        if (static_cast<size_t>(n) < chunk) { break; }
+      }
+      return sent;
+    }
+
+    // Sends several buffers as one, ie: a protocol header and its payload,
+    // so that they go out in a single send rather than one each
+    size_t writev(const TinyGsmIoVec* iov, uint8_t iovcnt) {
+      size_t total = 0;
+      for (uint8_t i = 0; i < iovcnt; i++) { total += iov[i].iov_len; }
+      TinyGsmIoVecSource source(iov, iovcnt);
+      size_t             sent = 0;
+      while (sent < total) {
+        size_t chunk = TinyGsmMin(
+            total - sent, static_cast<size_t>(modemType::Traits::maxSendSize));
+        int16_t n    = sendFrom(source, chunk);
+        if (n <= 0) { break; }
+        sent += n;
+        if (static_cast<size_t>(n) < chunk) { break; }
+      }
+      return sent;
+    }
+
     int available() override {
       TINY_GSM_YIELD();
 #if defined TINY_GSM_NO_MODEM_BUFFER
@@ -139,7 +314,7 @@ class TinyGsmTCP {
       // Returns the combined number of characters available in the TinyGSM
       // fifo and the modem chips internal fifo.
       if (!rx.size()) { at->maintain(); }
-      return static_cast<uint16_t>(rx.size()) + sock_available;
+      return rx.size() + sock_available;
 
 #elif defined TINY_GSM_BUFFER_READ_AND_CHECK_SIZE
       // Returns the combined number of characters available in the TinyGSM
@@ -154,7 +329,7 @@ class TinyGsmTCP {
         }
         at->maintain();
       }
-      return static_cast<uint16_t>(rx.size()) + sock_available;
+      return rx.size() + sock_available;
 
 #else
 #error Modem client has been incorrectly created
@@ -195,8 +370,7 @@ class TinyGsmTCP {
         } /* TODO: Read directly into user buffer? */
         at->maintain();
         if (sock_available > 0) {
-          int n = at->modemRead(TinyGsmMin((uint16_t)rx.free(), sock_available),
-                                mux);
+          int n = at->modemRead(readChunkSize(), mux);
           if (n == 0) break;
         } else {
           break;
@@ -227,8 +401,7 @@ class TinyGsmTCP {
         // TODO(vshymanskyy): Read directly into user buffer?
         at->maintain();
         if (sock_available > 0) {
-          int n = at->modemRead(TinyGsmMin((uint16_t)rx.free(), sock_available),
-                                mux);
+          int n = at->modemRead(readChunkSize(), mux);
           if (n == 0) break;
         } else {
           break;
@@ -241,6 +414,35 @@ class TinyGsmTCP {
 #endif
     }
 
+    // Reads up to len bytes into sink, ie: a file or flash.  Before each chunk
+    // goes to the sink the next one is already requested from the modem and
+    // waiting in the FIFO, so a slow write doesn't hold up the serial link.
+    // Stops early if nothing arrives for the client's timeout.
+    size_t readInto(Print& sink, size_t len, TinyGsmReadHook hook = nullptr,
+                    void* hook_arg = nullptr) {
+      uint8_t  chunk[TINY_GSM_READ_INTO_CHUNK];
+      size_t   done        = 0;
+      uint32_t startMillis = millis();
+      while (done < len) {
+        int n = read(chunk, TinyGsmMin(len - done, sizeof(chunk)));
+        if (n <= 0) {
+          if (millis() - startMillis > _timeout || !connected()) { break; }
+          continue;
+        }
+        startMillis = millis();
+#if defined TINY_GSM_BUFFER_READ_AND_CHECK_SIZE || \
+    defined TINY_GSM_BUFFER_READ_NO_CHECK
+        if (!rx.size() && sock_available > 0 && done + n < len) {
+          at->modemRead(readChunkSize(), mux);
+        }
+#endif
+        if (hook) { hook(chunk, n, hook_arg); }
+        sink.write(chunk, n);
+        done += n;
+      }
+      return done;
+    }
+
     int read() override {
       uint8_t c;
       if (read(&c, 1) == 1) { return c; }
@@ -268,8 +470,14 @@ class TinyGsmTCP {
 #elif defined TINY_GSM_NO_MODEM_BUFFER || defined TINY_GSM_BUFFER_READ_NO_CHECK
       // If the modem doesn't have an internal buffer, or if we can't check how
       // many characters are in the buffer then the cascade won't happen.
-      // We need to call modemGetConnected to check the sock state.
-      return at->modemGetConnected(mux);
+      // The drivers clear sock_connected on the modem's close URCs, so we
+      // only need to call modemGetConnected to check the sock state once in a
+      // while.
+      if (millis() - state_check > TINY_GSM_CONNECTED_CHECK_INTERVAL) {
+        sock_connected = at->modemGetConnected(mux);
+        state_check    = millis();
+      }
+      return sock_connected;
 #else
 #error Modem client has been incorrectly created
 #endif
@@ -284,7 +492,41 @@ class TinyGsmTCP {
 
     String remoteIP() TINY_GSM_ATTR_NOT_IMPLEMENTED;
 
+    // Receive into an external buffer instead of the built-in
+    // TINY_GSM_RX_BUFFER sized one, ie, a large buffer in PSRAM; pass nullptr
+    // to go back to the built-in buffer.  Anything already buffered is
+    // discarded.  Returns false, and goes back to the built-in buffer, if the
+    // buffer is too big for TINY_GSM_FIFO_INDEX_TYPE.
+    bool setRxBuffer(uint8_t* buf, size_t size) {
+      if (size >= RxFifo::max_size) {
+        DBG("### Rx buffer too big for TINY_GSM_FIFO_INDEX_TYPE:", size);
+        rx.setBuffer(nullptr, 0);
+        return false;
+      }
+      rx.setBuffer(buf, size);
+      return true;
+    }
+
    protected:
+    // The amount to request from the modem's buffer to fill the FIFO, no
+    // more than the module gives for one read command
+    inline size_t readChunkSize() {
+      size_t chunk = TinyGsmMin(static_cast<size_t>(rx.free()),
+                                sock_available);
+      return TinyGsmMin(chunk,
+                        static_cast<size_t>(modemType::Traits::maxReadSize));
+    }
+
+    // A single modem send of len bytes taken from source
+    int16_t sendFrom(TinyGsmSendSource& source, size_t len) {
+      TINY_GSM_YIELD();
+      at->maintain();
+      at->send_source = &source;
+      int16_t n       = at->modemSend(nullptr, len, mux);
+      at->send_source = nullptr;
+      return n;
+    }
+
     // Read and dump anything remaining in the modem's internal buffer.
     // Using this in the client stop() function.
     // The socket will appear open in response to connected() even after it
@@ -298,7 +540,7 @@ class TinyGsmTCP {
       uint32_t startMillis = millis();
       while (sock_available > 0 && (millis() - startMillis < maxWaitMs)) {
         rx.clear();
-        at->modemRead(TinyGsmMin((uint16_t)rx.free(), sock_available), mux);
+        at->modemRead(readChunkSize(), mux);
       }
       rx.clear();
       at->streamClear();
@@ -314,10 +556,14 @@ class TinyGsmTCP {
 
     modemType* at;
     uint8_t    mux;
-    uint16_t   sock_available;
+    size_t     sock_available;
     uint32_t   prev_check;
+    uint32_t   state_check;
     bool       sock_connected;
     bool       got_data;
+    // Waiting on the open URC from connectMany().  Only connectMany() sets it,
+    // so it starts cleared here rather than in each driver's init()
+    bool       sock_opening = false;
     RxFifo     rx;
   };
 
@@ -335,13 +581,20 @@ class TinyGsmTCP {
 #if defined TINY_GSM_BUFFER_READ_AND_CHECK_SIZE
     // Keep listening for modem URC's and proactively iterate through
     // sockets asking if any data is avaiable
+    int bulk_mux = -1;
     for (int mux = 0; mux < muxCount; mux++) {
       GsmClient* sock = thisModem().sockets[mux];
       if (sock && sock->got_data) {
-        sock->got_data       = false;
-        sock->sock_available = thisModem().modemGetAvailable(mux);
+        sock->got_data = false;
+        if (modemType::Traits::bulkAvailable) {
+          bulk_mux = mux;
+        } else {
+          sock->sock_available = thisModem().modemGetAvailable(mux);
+        }
       }
     }
+    // One query updates every socket
+    if (bulk_mux >= 0) { thisModem().modemGetAvailable(bulk_mux); }
     while (thisModem().stream.available()) {
       thisModem().waitResponse(15, nullptr, nullptr);
     }
@@ -355,6 +608,129 @@ class TinyGsmTCP {
 #endif
   }
 
+  /*
+   * Client functions
+   */
+ protected:
+  template <class clientType>
+  uint8_t connectManyImpl(clientType* clients[], const char* const hosts[],
+                          const uint16_t ports[], uint8_t count,
+                          int timeout_s) {
+    uint8_t connected = 0;
+    for (uint8_t i = 0; i < count; i++) {
+      if (clients[i]->connect(hosts[i], ports[i], timeout_s)) { connected++; }
+    }
+    return connected;
+  }
+
+  // For modules with an asynchronous open: sends every open command with
+  // modemBeginConnect() and then waits while handleURCs() picks up the results,
+  // clearing sock_opening and setting sock_connected for each.  The modem must
+  // also have TinyGsmDNS, to drop the cached address of a host that failed.
+  template <class clientType>
+  uint8_t connectManyConcurrent(clientType* clients[],
+                                const char* const hosts[],
+                                const uint16_t ports[], uint8_t count,
+                                int timeout_s) {
+    uint32_t timeout_ms = ((uint32_t)timeout_s) * 1000;
+    for (uint8_t i = 0; i < count; i++) {
+      clientType* sock = clients[i];
+      sock->stop();
+      TINY_GSM_YIELD();
+      sock->rx.clear();
+      sock->sock_connected = false;
+      sock->sock_opening   = true;
+      if (!thisModem().modemBeginConnect(hosts[i], ports[i], sock->mux,
+                                         timeout_s)) {
+        sock->sock_opening = false;
+      }
+    }
+
+    uint32_t startMillis = millis();
+    bool     opening     = true;
+    while (opening && millis() - startMillis < timeout_ms) {
+      thisModem().waitResponse(100, nullptr, nullptr);
+      opening = false;
+      for (uint8_t i = 0; i < count; i++) {
+        if (clients[i]->sock_opening) { opening = true; }
+      }
+    }
+
+    uint8_t connected = 0;
+    for (uint8_t i = 0; i < count; i++) {
+      if (clients[i]->sock_opening) {
+        DBG("### Timed out opening socket", clients[i]->mux);
+        clients[i]->sock_opening = false;
+        clients[i]->stop();
+      }
+      if (clients[i]->sock_connected) {
+        connected++;
+      } else {
+        thisModem().forgetHostIP(hosts[i]);
+      }
+    }
+    return connected;
+  }
+
+  // Sends the application's last data for now.  Modules that can tell the
+  // network that no more data is expected override this.
+  int16_t modemSendLast(const void* buff, size_t len, uint8_t mux) {
+    return thisModem().modemSend(buff, len, mux);
+  }
+
+  // For modules with 3GPP TS 27.007 AT+CNMPSD: sends the data and then
+  // indicates that no more is expected, so the network can release the
+  // connection straight away
+  int16_t modemSendThenCNMPSD(const void* buff, size_t len, uint8_t mux) {
+    int16_t sent = thisModem().modemSend(buff, len, mux);
+    if (sent > 0) {
+      thisModem().sendAT(GF("+CNMPSD"));
+      thisModem().waitResponse();
+    }
+    return sent;
+  }
+
+  // Copies up to len bytes of a send, starting offset bytes in, into chunk:
+  // from buff, or from the send_source if there is one
+  inline size_t readSendData(const void* buff, size_t offset, uint8_t* chunk,
+                             size_t len) {
+    if (send_source) { return send_source->read(chunk, len); }
+    memcpy(chunk, reinterpret_cast<const uint8_t*>(buff) + offset, len);
+    return len;
+  }
+
+  // Writes the data of a send, once the module has asked for it
+  inline void streamWriteSendData(const void* buff, size_t len) {
+    if (!send_source) {
+      thisModem().stream.write(reinterpret_cast<const uint8_t*>(buff), len);
+      return;
+    }
+    uint8_t chunk[32];
+    for (size_t i = 0; i < len;) {
+      size_t n = readSendData(buff, i, chunk,
+                              TinyGsmMin(len - i, sizeof(chunk)));
+      if (n == 0) break;
+      thisModem().stream.write(chunk, n);
+      i += n;
+    }
+  }
+
+  // Writes the data of a send as two hex characters per byte
+  inline void streamWriteSendDataHex(const void* buff, size_t len) {
+    static const char digits[] = "0123456789ABCDEF";
+    uint8_t           chunk[16];
+    for (size_t i = 0; i < len;) {
+      size_t n = readSendData(buff, i, chunk,
+                              TinyGsmMin(len - i, sizeof(chunk)));
+      if (n == 0) break;
+      for (size_t j = 0; j < n; j++) {
+        thisModem().stream.write(digits[chunk[j] >> 4]);
+        thisModem().stream.write(digits[chunk[j] & 0x0F]);
+      }
+      i += n;
+    }
+  }
+
   // Yields up to a time-out period and then reads a character from the stream
   // into the mux FIFO
   // TODO(SRGDamia1):  Do we really need to wait _two_ timeout periods for no
@@ -371,6 +747,62 @@ class TinyGsmTCP {
     char c = thisModem().stream.read();
     thisModem().sockets[mux]->rx.put(c);
   }
+
+  // Reads len bytes sent as pairs of hex characters from the stream into the
+  // mux FIFO, decoding them a chunk at a time.  Gives up when nothing arrives
+  // for the socket's time-out; only whole pairs are ever decoded.
+  inline void moveHexFromStreamToFifo(uint8_t mux, size_t len) {
+    if (!thisModem().sockets[mux]) return;
+    uint32_t buf[16];  // word aligned, so the decoder can use its fast path
+    char*    hex         = reinterpret_cast<char*>(buf);
+    uint32_t timeout_ms  = thisModem().sockets[mux]->_timeout;
+    uint32_t startMillis = millis();
+    while (len) {
+      size_t want = TinyGsmMin(len, sizeof(buf) / 2) * 2;
+      size_t have = 0;
+      while (have < want && millis() - startMillis < timeout_ms) {
+        int avail = thisModem().stream.available();
+        if (avail <= 0) {
+          TINY_GSM_YIELD();
+          continue;
+        }
+        have += thisModem().stream.readBytes(
+            hex + have, TinyGsmMin(want - have, static_cast<size_t>(avail)));
+        startMillis = millis();
+      }
+      size_t got = have / 2;
+      TinyGsmHexToBytes(hex, reinterpret_cast<uint8_t*>(hex), got);
+      thisModem().sockets[mux]->rx.put(reinterpret_cast<uint8_t*>(hex), got);
+      if (have < want) {
+        DBG("### Hex data timed out with", len - got, "bytes to go");
+        break;
+      }
+      len -= got;
+    }
+  }
+
+  TinyGsmSendSource* send_source;
+};
+
+/*
+ * A client with its own receive buffer size, regardless of TINY_GSM_RX_BUFFER,
+ * ie: TinyGsmClientRx<TinyGsmClient, 4096> bulkClient(modem, 0);
+ * With TINY_GSM_RX_BUFFER set to 0 this is the only buffer the client has.
+ */
+template <class clientType, size_t rxSize>
+class TinyGsmClientRx : public clientType {
+  static_assert(rxSize > 1, "The receive buffer always keeps one byte free");
+  static_assert(rxSize < TinyGsmFifo<uint8_t, 0>::max_size,
+                "Receive buffer is too big for TINY_GSM_FIFO_INDEX_TYPE");
+
+ public:
+  template <typename... Args>
+  explicit TinyGsmClientRx(Args&&... args) : clientType(args...) {
+    this->setRxBuffer(rx_storage, rxSize);
+  }
+
+ protected:
+  uint8_t rx_storage[rxSize];
 };
 
 #endif  // SRC_TINYGSMTCP_H_
@@ -0,0 +1,231 @@
+/**************************************************************
+ *
+ * Benchmarks TinyGsmResumableDownload against the extras/test_*.bin
+ * files, served by the stand-in server in tools/DownloadServer:
+ *
+ *   python3 tools/DownloadServer/download_server.py --port 8080
+ *
+ * Add --drop 30000 --drop-step 30000 to cut every response short and
+ * time the resumes, or --rate to slow the server down.
+ *
+ * TinyGSM Getting Started guide:
+ *   https://tiny.cc/tinygsm-readme
+ *
+ **************************************************************/
+
+// Select your modem:
+#define TINY_GSM_MODEM_SIM800
+// #define TINY_GSM_MODEM_SIM808
+// #define TINY_GSM_MODEM_SIM868
+// #define TINY_GSM_MODEM_SIM900
+// #define TINY_GSM_MODEM_SIM7000
+// #define TINY_GSM_MODEM_SIM7000SSL
+// #define TINY_GSM_MODEM_SIM7080
+// #define TINY_GSM_MODEM_SIM5360
+// #define TINY_GSM_MODEM_SIM7600
+// #define TINY_GSM_MODEM_A7672X
+// #define TINY_GSM_MODEM_UBLOX
+// #define TINY_GSM_MODEM_SARAR4
+// #define TINY_GSM_MODEM_SARAR5
+// #define TINY_GSM_MODEM_M95
+// #define TINY_GSM_MODEM_BG95
+// #define TINY_GSM_MODEM_BG96
+// #define TINY_GSM_MODEM_A6
+// #define TINY_GSM_MODEM_A7
+// #define TINY_GSM_MODEM_M590
+// #define TINY_GSM_MODEM_MC60
+// #define TINY_GSM_MODEM_MC60E
+// #define TINY_GSM_MODEM_ESP8266
+// #define TINY_GSM_MODEM_ESP32
+// #define TINY_GSM_MODEM_XBEE
+// #define TINY_GSM_MODEM_SEQUANS_MONARCH
+
+// Set serial for debug console (to the Serial Monitor, default speed 115200)
+#define SerialMon Serial
+
+// Set serial for AT commands (to the module)
+// Use Hardware Serial on Mega, Leonardo, Micro
+#ifndef __AVR_ATmega328P__
+#define SerialAT Serial1
+
+// or Software Serial on Uno, Nano
+#else
+#include <SoftwareSerial.h>
+SoftwareSerial SerialAT(2, 3);  // RX, TX
+#endif
+
+// Chips without internal buffering (A6/A7, ESP8266, M590) need enough space
+// in the buffer for the data arriving between reads
+#ifndef TINY_GSM_RX_BUFFER
+#define TINY_GSM_RX_BUFFER 1024
+#endif
+
+// See all AT commands, if wanted
+// #define DUMP_AT_COMMANDS
+
+// Define the serial console for debug prints, if needed
+#define TINY_GSM_DEBUG SerialMon
+
+#define TINY_GSM_USE_GPRS true
+#define TINY_GSM_USE_WIFI false
+
+// set GSM PIN, if any
+#define GSM_PIN ""
+
+// Your GPRS credentials, if any
+const char apn[]      = "YourAPN";
+const char gprsUser[] = "";
+const char gprsPass[] = "";
+
+// Your WiFi connection credentials, if applicable
+const char wifiSSID[] = "YourSSID";
+const char wifiPass[] = "YourWiFiPass";
+
+// The machine running download_server.py
+const char server[] = "192.168.1.10";
+const int  port     = 8080;
+
+#include <TinyGsmClient.h>
+#include <TinyGsmHttpDownload.h>
+
+// Just in case someone defined the wrong thing..
+#if TINY_GSM_USE_GPRS && not defined TINY_GSM_MODEM_HAS_GPRS
+#undef TINY_GSM_USE_GPRS
+#undef TINY_GSM_USE_WIFI
+#define TINY_GSM_USE_GPRS false
+#define TINY_GSM_USE_WIFI true
+#endif
+#if TINY_GSM_USE_WIFI && not defined TINY_GSM_MODEM_HAS_WIFI
+#undef TINY_GSM_USE_GPRS
+#undef TINY_GSM_USE_WIFI
+#define TINY_GSM_USE_GPRS true
+#define TINY_GSM_USE_WIFI false
+#endif
+
+#ifdef DUMP_AT_COMMANDS
+#include <StreamDebugger.h>
+StreamDebugger debugger(SerialAT, SerialMon);
+TinyGsm        modem(debugger);
+#else
+TinyGsm        modem(SerialAT);
+#endif
+
+TinyGsmClient client(modem);
+
+struct TestFile {
+  const char* path;
+  uint32_t    size;
+  uint32_t    crc32;
+};
+
+const TestFile files[] = {
+    {"/test_1k.bin", 1024, 0x6f50d767},
+    {"/test_10k.bin", 10240, 0x5a56b0fd},
+    {"/test_100k.bin", 102400, 0x99e1b820},
+    {"/test_1m.bin", 1048576, 0xbe74c743},
+};
+
+// Throws the data away; only the CRC-32 is kept
+class NullSink : public TinyGsmDownloadSink {
+ public:
+  bool write(uint32_t, const uint8_t*, size_t) override {
+    return true;
+  }
+};
+
+void setup() {
+  // Set console baud rate
+  SerialMon.begin(115200);
+  delay(10);
+
+  // !!!!!!!!!!!
+  // Set your reset, enable, power pins here
+  // !!!!!!!!!!!
+
+  SerialMon.println("Wait...");
+
+  // Set GSM module baud rate
+  SerialAT.begin(115200);
+  delay(6000);
+
+  SerialMon.println("Initializing modem...");
+  modem.restart();
+
+#if TINY_GSM_USE_GPRS
+  // Unlock your SIM card with a PIN if needed
+  if (GSM_PIN && modem.getSimStatus() != 3) { modem.simUnlock(GSM_PIN); }
+#endif
+}
+
+void loop() {
+#if TINY_GSM_USE_WIFI
+  SerialMon.print(F("Setting SSID/password..."));
+  if (!modem.networkConnect(wifiSSID, wifiPass)) {
+    SerialMon.println(" fail");
+    delay(10000);
+    return;
+  }
+  SerialMon.println(" success");
+#endif
+
+#if TINY_GSM_USE_GPRS && defined TINY_GSM_MODEM_XBEE
+  // The XBee must run the gprsConnect function BEFORE waiting for network!
+  modem.gprsConnect(apn, gprsUser, gprsPass);
+#endif
+
+  SerialMon.print("Waiting for network...");
+  if (!modem.waitForNetwork()) {
+    SerialMon.println(" fail");
+    delay(10000);
+    return;
+  }
+  SerialMon.println(" success");
+
+#if TINY_GSM_USE_GPRS
+  SerialMon.print(F("Connecting to "));
+  SerialMon.print(apn);
+  if (!modem.gprsConnect(apn, gprsUser, gprsPass)) {
+    SerialMon.println(" fail");
+    delay(10000);
+    return;
+  }
+  SerialMon.println(" success");
+#endif
+
+  for (const TestFile& file : files) {
+    TinyGsmResumableDownload<TinyGsmClient> download(client);
+    download.setRetries(10, 500, 5000);
+    NullSink sink;
+
+    uint32_t start = millis();
+    bool     ok    = download.get(server, port, file.path, sink);
+    float    secs  = (millis() - start) / 1000.0;
+
+    SerialMon.println();
+    SerialMon.println(file.path);
+    SerialMon.print("  Received: ");
+    SerialMon.print(download.received());
+    SerialMon.print(" of ");
+    SerialMon.println(file.size);
+    SerialMon.print("  CRC32:    0x");
+    SerialMon.print(download.crc32(), HEX);
+    SerialMon.println(ok && download.crc32() == file.crc32 ? " (ok)"
+                                                           : " (FAILED)");
+    SerialMon.print("  Duration: ");
+    SerialMon.print(secs);
+    SerialMon.println("s");
+    SerialMon.print("  Speed:    ");
+    SerialMon.print(secs > 0 ? download.received() / 1024.0 / secs : 0);
+    SerialMon.println(" kB/s");
+  }
+
+#if TINY_GSM_USE_WIFI
+  modem.networkDisconnect();
+#endif
+#if TINY_GSM_USE_GPRS
+  modem.gprsDisconnect();
+#endif
+
+  // Do nothing forevermore
+  while (true) { delay(1000); }
+}
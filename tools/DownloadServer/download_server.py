@@ -0,0 +1,103 @@
+#!/usr/bin/env python3
+"""
+Stand-in HTTP server for the DownloadBenchmark tool.
+
+Serves the extras/test_*.bin fixtures with HTTP Range support, and can drop
+connections part way through a response to exercise a resumable download.
+
+    python3 download_server.py --port 8080 --drop 30000
+
+Then point the benchmark sketch at this machine's address and port.
+"""
+
+import argparse
+import http.server
+import os
+import re
+import socketserver
+import time
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "..",
+                    "extras")
+
+
+class Handler(http.server.BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.0"
+
+    def do_GET(self):
+        name = os.path.basename(self.path.split("?")[0])
+        path = os.path.join(self.server.args.root, name)
+        if not name or not os.path.isfile(path):
+            self.send_error(404)
+            return
+        with open(path, "rb") as f:
+            data = f.read()
+        size = len(data)
+
+        first, last = 0, size - 1
+        status = 200
+        ranged = self.headers.get("Range")
+        m = re.match(r"bytes=(\d+)-(\d*)$", ranged or "")
+        if m:
+            first = int(m.group(1))
+            if m.group(2):
+                last = min(int(m.group(2)), size - 1)
+            if first >= size:
+                self.send_response(416)
+                self.send_header("Content-Range", "bytes */%d" % size)
+                self.end_headers()
+                return
+            status = 206
+        body = data[first:last + 1]
+
+        self.send_response(status)
+        if status == 206:
+            total = "*" if self.server.args.unknown_size else str(size)
+            self.send_header("Content-Range",
+                             "bytes %d-%d/%s" % (first, last, total))
+        if not self.server.args.no_length:
+            self.send_header("Content-Length", str(len(body)))
+        self.send_header("Content-Type", "application/octet-stream")
+        self.end_headers()
+
+        # Send in chunks, optionally throttled and cut short
+        limit = len(body)
+        if self.server.args.drop and first + limit > self.server.args.drop:
+            limit = max(0, self.server.args.drop - first)
+            self.server.args.drop += self.server.args.drop_step
+        chunk = 1024
+        for i in range(0, limit, chunk):
+            self.wfile.write(body[i:min(i + chunk, limit)])
+            if self.server.args.rate:
+                time.sleep(float(chunk) / self.server.args.rate)
+        if limit < len(body):
+            self.log_message("dropped %s at byte %d", name, first + limit)
+            self.close_connection = True
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().split("\n")[0])
+    parser.add_argument("--port", type=int, default=8080)
+    parser.add_argument("--root", default=ROOT,
+                        help="directory to serve (default: extras/)")
+    parser.add_argument("--drop", type=int, default=0,
+                        help="close the connection at this byte of the file")
+    parser.add_argument("--drop-step", type=int, default=0,
+                        help="move the drop point on by this much each time")
+    parser.add_argument("--rate", type=int, default=0,
+                        help="limit each response to this many bytes/s")
+    parser.add_argument("--no-length", action="store_true",
+                        help="leave out Content-Length")
+    parser.add_argument("--unknown-size", action="store_true",
+                        help="answer ranges with Content-Range bytes a-b/*")
+    args = parser.parse_args()
+
+    socketserver.ThreadingTCPServer.allow_reuse_address = True
+    server = socketserver.ThreadingTCPServer(("", args.port), Handler)
+    server.args = args
+    print("Serving %s on port %d" % (os.path.abspath(args.root), args.port))
+    server.serve_forever()
+
+
+if __name__ == "__main__":
+    main()